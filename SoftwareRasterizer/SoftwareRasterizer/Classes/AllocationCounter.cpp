@@ -0,0 +1,112 @@
+/****************************************************************************
+ * ==> AllocationCounter ---------------------------------------------------*
+ ****************************************************************************
+ * Description: Heap allocation counter, for debugging                      *
+ * Developer:   Jean-Milost Reymond                                         *
+ ****************************************************************************
+ * MIT License                                                              *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files (the            *
+ * "Software"), to deal in the Software without restriction, including      *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sub-license, and/or sell copies of the Software, and to      *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+#include "AllocationCounter.h"
+
+#if ALLOCATION_COUNTER
+    // std
+    #include <atomic>
+    #include <cstdlib>
+    #include <new>
+#endif
+
+using namespace Debug;
+
+#if ALLOCATION_COUNTER
+    std::atomic<std::size_t> g_AllocationCount       = { 0 };
+    thread_local std::size_t g_ThreadAllocationCount = 0;
+
+    //---------------------------------------------------------------------------
+    // Global new and delete operators
+    //---------------------------------------------------------------------------
+    void* operator new(std::size_t size)
+    {
+        g_AllocationCount.fetch_add(1, std::memory_order_relaxed);
+        ++g_ThreadAllocationCount;
+
+        // the returned pointer should be unique, even for an empty block
+        if (!size)
+            size = 1;
+
+        for (;;)
+        {
+            void* pBlock = std::malloc(size);
+
+            if (pBlock)
+                return pBlock;
+
+            // out of memory, let the application release some if it can
+            std::new_handler pHandler = std::get_new_handler();
+
+            if (!pHandler)
+                throw std::bad_alloc();
+
+            pHandler();
+        }
+    }
+    //---------------------------------------------------------------------------
+    void operator delete(void* pBlock) noexcept
+    {
+        std::free(pBlock);
+    }
+    //---------------------------------------------------------------------------
+    void operator delete(void* pBlock, std::size_t) noexcept
+    {
+        std::free(pBlock);
+    }
+    //---------------------------------------------------------------------------
+#endif
+
+//---------------------------------------------------------------------------
+// AllocationCounter
+//---------------------------------------------------------------------------
+std::size_t AllocationCounter::Get()
+{
+    #if ALLOCATION_COUNTER
+        return g_AllocationCount.load(std::memory_order_relaxed);
+    #else
+        return 0;
+    #endif
+}
+//---------------------------------------------------------------------------
+std::size_t AllocationCounter::GetThread()
+{
+    #if ALLOCATION_COUNTER
+        return g_ThreadAllocationCount;
+    #else
+        return 0;
+    #endif
+}
+//---------------------------------------------------------------------------
+void AllocationCounter::AddThread(std::size_t count)
+{
+    #if ALLOCATION_COUNTER
+        g_ThreadAllocationCount += count;
+    #endif
+}
+//---------------------------------------------------------------------------
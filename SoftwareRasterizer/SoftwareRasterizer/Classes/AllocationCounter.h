@@ -0,0 +1,71 @@
+/****************************************************************************
+ * ==> AllocationCounter ---------------------------------------------------*
+ ****************************************************************************
+ * Description: Heap allocation counter, for debugging                      *
+ * Developer:   Jean-Milost Reymond                                         *
+ ****************************************************************************
+ * MIT License                                                              *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files (the            *
+ * "Software"), to deal in the Software without restriction, including      *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sub-license, and/or sell copies of the Software, and to      *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+#pragma once
+
+// std
+#include <cstddef>
+
+// replaces the global new operator to count the heap allocations. Enabled by default in debug builds
+#ifndef ALLOCATION_COUNTER
+    #ifdef _DEBUG
+        #define ALLOCATION_COUNTER 1
+    #else
+        #define ALLOCATION_COUNTER 0
+    #endif
+#endif
+
+namespace Debug
+{
+    /**
+    * Heap allocation counter, counts the allocations made by the global new operator on all the threads
+    *@note The count is always 0 if ALLOCATION_COUNTER isn't enabled
+    *@author Jean-Milost Reymond
+    */
+    class AllocationCounter
+    {
+        public:
+            /**
+            * Gets the number of heap allocations made since the application started
+            *@return allocation count
+            */
+            static std::size_t Get();
+
+            /**
+            * Gets the number of heap allocations made by the calling thread since it started, or on its behalf
+            *@return allocation count
+            */
+            static std::size_t GetThread();
+
+            /**
+            * Adds allocations made on behalf of the calling thread, e.g. by the workers running its jobs
+            *@param count - allocation count to add
+            */
+            static void AddThread(std::size_t count);
+    };
+}
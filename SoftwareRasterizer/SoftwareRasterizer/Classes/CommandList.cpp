@@ -0,0 +1,64 @@
+/****************************************************************************
+ * ==> CommandList ---------------------------------------------------------*
+ ****************************************************************************
+ * Description: Draw commands recorded to be sorted and executed later      *
+ * Developer:   Jean-Milost Reymond                                         *
+ ****************************************************************************
+ * MIT License                                                              *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files (the            *
+ * "Software"), to deal in the Software without restriction, including      *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sub-license, and/or sell copies of the Software, and to      *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+#include "CommandList.h"
+
+using namespace Rasterizer;
+
+//---------------------------------------------------------------------------
+// CommandList
+//---------------------------------------------------------------------------
+CommandList::CommandList()
+{}
+//---------------------------------------------------------------------------
+CommandList::~CommandList()
+{}
+//---------------------------------------------------------------------------
+void CommandList::Draw(const Model::MeshCompiler::IMeshView& mesh,
+                       const Math::Matrix4x4F&               model,
+                             std::size_t                     texture,
+                             Renderer::IECullingType         cullingType,
+                             Renderer::IECullingFace         cullingFace)
+{
+    m_Commands.push_back({mesh, model, texture, cullingType, cullingFace});
+}
+//---------------------------------------------------------------------------
+void CommandList::Append(const CommandList& other)
+{
+    m_Commands.insert(m_Commands.end(), other.m_Commands.begin(), other.m_Commands.end());
+}
+//---------------------------------------------------------------------------
+void CommandList::Clear()
+{
+    m_Commands.clear();
+}
+//---------------------------------------------------------------------------
+const CommandList::ICommands& CommandList::GetCommands() const
+{
+    return m_Commands;
+}
@@ -0,0 +1,102 @@
+/****************************************************************************
+ * ==> CommandList ---------------------------------------------------------*
+ ****************************************************************************
+ * Description: Draw commands recorded to be sorted and executed later      *
+ * Developer:   Jean-Milost Reymond                                         *
+ ****************************************************************************
+ * MIT License                                                              *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files (the            *
+ * "Software"), to deal in the Software without restriction, including      *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sub-license, and/or sell copies of the Software, and to      *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+#pragma once
+
+// std
+#include <vector>
+#include <cstddef>
+
+// classes
+#include "Matrix4x4.h"
+#include "MeshCompiler.h"
+#include "SoftwareRenderer.h"
+
+namespace Rasterizer
+{
+    /**
+    * Command list, records draw commands instead of executing them immediately, so the renderer may sort
+    * them before. A list isn't thread safe, but each thread may record its own list, then the lists may be
+    * merged into one
+    *@author Jean-Milost Reymond
+    */
+    class CommandList
+    {
+        public:
+            /**
+            * Draw command
+            */
+            struct ICommand
+            {
+                Model::MeshCompiler::IMeshView m_Mesh;
+                Math::Matrix4x4F               m_Model;
+                std::size_t                    m_Texture;     // texture index, as returned by Renderer::LoadTexture()
+                Renderer::IECullingType        m_CullingType;
+                Renderer::IECullingFace        m_CullingFace;
+            };
+
+            typedef std::vector<ICommand> ICommands;
+
+            CommandList();
+            virtual ~CommandList();
+
+            /**
+            * Records a mesh draw
+            *@param mesh - mesh to draw, should remain unchanged until the list is executed
+            *@param model - model matrix
+            *@param texture - texture index, as returned by Renderer::LoadTexture()
+            *@param cullingType - culling type
+            *@param cullingFace - culling face
+            */
+            void Draw(const Model::MeshCompiler::IMeshView& mesh,
+                      const Math::Matrix4x4F&               model,
+                            std::size_t                     texture,
+                            Renderer::IECullingType         cullingType = Renderer::IECullingType::Back,
+                            Renderer::IECullingFace         cullingFace = Renderer::IECullingFace::CW);
+
+            /**
+            * Appends the commands of another list
+            *@param other - list to append, may have been recorded by another thread, which should be done
+            */
+            void Append(const CommandList& other);
+
+            /**
+            * Clears the list, keeping its memory for the next frame
+            */
+            void Clear();
+
+            /**
+            * Gets the recorded commands
+            *@return the commands, in recording order
+            */
+            const ICommands& GetCommands() const;
+
+        private:
+            ICommands m_Commands;
+    };
+}
@@ -0,0 +1,114 @@
+/****************************************************************************
+ * ==> MappedFile ----------------------------------------------------------*
+ ****************************************************************************
+ * Description: Read only memory mapped file                                *
+ * Developer:   Jean-Milost Reymond                                         *
+ ****************************************************************************
+ * MIT License                                                              *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files (the            *
+ * "Software"), to deal in the Software without restriction, including      *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sub-license, and/or sell copies of the Software, and to      *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+#include "MappedFile.h"
+
+using namespace IO;
+
+//---------------------------------------------------------------------------
+// MappedFile
+//---------------------------------------------------------------------------
+MappedFile::MappedFile()
+{}
+//---------------------------------------------------------------------------
+MappedFile::~MappedFile()
+{
+    Close();
+}
+//---------------------------------------------------------------------------
+bool MappedFile::Open(const std::string& fileName)
+{
+    Close();
+
+    m_hFile = ::CreateFileA(fileName.c_str(),
+                            GENERIC_READ,
+                            FILE_SHARE_READ,
+                            nullptr,
+                            OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                            nullptr);
+
+    if (m_hFile == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+
+    if (!::GetFileSizeEx(m_hFile, &size))
+    {
+        Close();
+        return false;
+    }
+
+    // an empty file can't be mapped, but is still valid
+    if (!size.QuadPart)
+        return true;
+
+    m_hMapping = ::CreateFileMappingA(m_hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+    if (!m_hMapping)
+    {
+        Close();
+        return false;
+    }
+
+    m_pData = (const char*)::MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0);
+
+    if (!m_pData)
+    {
+        Close();
+        return false;
+    }
+
+    m_Size = (std::size_t)size.QuadPart;
+
+    return true;
+}
+//---------------------------------------------------------------------------
+void MappedFile::Close()
+{
+    if (m_pData)
+    {
+        ::UnmapViewOfFile(m_pData);
+        m_pData = nullptr;
+    }
+
+    if (m_hMapping)
+    {
+        ::CloseHandle(m_hMapping);
+        m_hMapping = nullptr;
+    }
+
+    if (m_hFile != INVALID_HANDLE_VALUE)
+    {
+        ::CloseHandle(m_hFile);
+        m_hFile = INVALID_HANDLE_VALUE;
+    }
+
+    m_Size = 0;
+}
+//---------------------------------------------------------------------------
@@ -0,0 +1,100 @@
+/****************************************************************************
+ * ==> MappedFile ----------------------------------------------------------*
+ ****************************************************************************
+ * Description: Read only memory mapped file                                *
+ * Developer:   Jean-Milost Reymond                                         *
+ ****************************************************************************
+ * MIT License                                                              *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files (the            *
+ * "Software"), to deal in the Software without restriction, including      *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sub-license, and/or sell copies of the Software, and to      *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+#pragma once
+
+// std
+#include <cstddef>
+#include <string>
+
+// windows
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+
+namespace IO
+{
+    /**
+    * Read only memory mapped file, the file content is accessed in place, without being read or copied
+    *@author Jean-Milost Reymond
+    */
+    class MappedFile
+    {
+        public:
+            MappedFile();
+            virtual ~MappedFile();
+
+            MappedFile(const MappedFile& other) = delete;
+            MappedFile& operator = (const MappedFile& other) = delete;
+
+            /**
+            * Opens and maps a file
+            *@param fileName - file name to open
+            *@return true on success, otherwise false
+            *@note An empty file is opened successfully, but without data
+            */
+            bool Open(const std::string& fileName);
+
+            /**
+            * Unmaps and closes the file
+            */
+            void Close();
+
+            /**
+            * Gets the file content
+            *@return the file content, nullptr if the file isn't opened or is empty
+            */
+            inline const char* GetData() const;
+
+            /**
+            * Gets the file size
+            *@return the file size in bytes
+            */
+            inline std::size_t GetSize() const;
+
+        private:
+            HANDLE      m_hFile    = INVALID_HANDLE_VALUE;
+            HANDLE      m_hMapping = nullptr;
+            const char* m_pData    = nullptr;
+            std::size_t m_Size     = 0;
+    };
+
+    //---------------------------------------------------------------------------
+    // MappedFile
+    //---------------------------------------------------------------------------
+    inline const char* MappedFile::GetData() const
+    {
+        return m_pData;
+    }
+    //---------------------------------------------------------------------------
+    inline std::size_t MappedFile::GetSize() const
+    {
+        return m_Size;
+    }
+    //---------------------------------------------------------------------------
+}
@@ -31,10 +31,25 @@
 // std
 #include <memory>
 #include <cmath>
+#include <cstddef>
+#include <type_traits>
 
 // classes
 #include "Vector3.h"
 
+// the float array transforms process 4 vectors at once with SSE instructions, if available
+#ifndef MATRIX4X4_SSE
+    #if defined(_M_X64) || defined(_M_IX86) || defined(__SSE__)
+        #define MATRIX4X4_SSE 1
+    #else
+        #define MATRIX4X4_SSE 0
+    #endif
+#endif
+
+#if MATRIX4X4_SSE
+    #include <xmmintrin.h>
+#endif
+
 namespace Math
 {
     /**
@@ -80,32 +95,27 @@ namespace Math
             * Copy constructor
             *@param other - other matrix to copy from
             */
-            inline Matrix4x4(const Matrix4x4& other);
-
-            /**
-            * Destructor
-            */
-            virtual inline ~Matrix4x4();
+            Matrix4x4(const Matrix4x4& other) = default;
 
             /**
             * Assignation operator
             *@param other - other matrix to copy from
             */
-            virtual inline Matrix4x4& operator = (const Matrix4x4& other);
+            Matrix4x4& operator = (const Matrix4x4& other) = default;
 
             /**
             * Equality operator
             *@param other - other matrix to compare
             *@return true if both matrix are equals, otherwise false
             */
-            virtual inline bool operator == (const Matrix4x4& other);
+            inline bool operator == (const Matrix4x4& other);
 
             /**
             * Not equality operator
             *@param other - other matrix to compare
             *@return true if both matrix are not equals, otherwise false
             */
-            virtual inline bool operator != (const Matrix4x4& other);
+            inline bool operator != (const Matrix4x4& other);
 
             /**
             * Set matrix content
@@ -126,29 +136,29 @@ namespace Math
             *@param _43 - matrix value
             *@param _44 - matrix value
             */
-            virtual inline void Set(T _11, T _12, T _13, T _14,
-                                    T _21, T _22, T _23, T _24,
-                                    T _31, T _32, T _33, T _34,
-                                    T _41, T _42, T _43, T _44);
+            inline void Set(T _11, T _12, T _13, T _14,
+                            T _21, T _22, T _23, T _24,
+                            T _31, T _32, T _33, T _34,
+                            T _41, T _42, T _43, T _44);
 
             /**
             * Copies matrix from another
             *@param other - other matrix to copy from
             */
-            virtual inline void Copy(const Matrix4x4& other);
+            inline void Copy(const Matrix4x4& other);
 
             /**
             * Checks if matrix and other matrix are equals
             *@param other - other matrix to compare
             *@return true if matrix are equals, otherwise false
             */
-            virtual inline bool IsEqual(const Matrix4x4& other) const;
+            inline bool IsEqual(const Matrix4x4& other) const;
 
             /**
             * Checks if matrix is an identity matrix
             *@return true if matrix is an identity matrix, otherwise false
             */
-            virtual inline bool IsIdentity() const;
+            inline bool IsIdentity() const;
 
             /**
             * Gets an identity matrix
@@ -160,27 +170,27 @@ namespace Math
             * Inverses a matrix
             *@param[out] determinant - matrix determinant
             */
-            virtual inline Matrix4x4 Inverse(float& determinant) const;
+            inline Matrix4x4 Inverse(float& determinant) const;
 
             /**
             * Transposes a matrix
             *@return transposed matrix
             */
-            virtual inline Matrix4x4 Transpose() const;
+            inline Matrix4x4 Transpose() const;
 
             /**
             * Multiplies matrix by another matrix
             *@param other - other matrix to multiply with
             *@return multiplied resulting matrix
             */
-            virtual inline Matrix4x4 Multiply(const Matrix4x4& other) const;
+            inline Matrix4x4 Multiply(const Matrix4x4& other) const;
 
             /**
             * Translates matrix
             *@param t - translation vector
             *@return copy of translated matrix
             */
-            virtual inline Matrix4x4 Translate(const Vector3<T>& t);
+            inline Matrix4x4 Translate(const Vector3<T>& t);
 
             /**
             * Rotates matrix
@@ -190,39 +200,88 @@ namespace Math
             *@note rotation direction vector should be normalized before calling
             *      this function
             */
-            virtual inline Matrix4x4 Rotate(T angle, const Vector3<T>& r);
+            inline Matrix4x4 Rotate(T angle, const Vector3<T>& r);
 
             /**
             * Scales matrix
             *@param s - scale vector
             *@return copy of scaled matrix
             */
-            virtual inline Matrix4x4 Scale(const Vector3<T>& s);
+            inline Matrix4x4 Scale(const Vector3<T>& s);
 
             /**
             * Applies a transformation matrix to a vector
             *@param vector - vector to transform
             *@return transformed vector
             */
-            virtual inline Vector3<T> Transform(const Vector3<T>& vector) const;
+            inline Vector3<T> Transform(const Vector3<T>& vector) const;
 
             /**
             * Applies a transformation matrix to a normal
             *@param normal - normal to transform
             *@return transformed normal
             */
-            virtual inline Vector3<T> TransformNormal(const Vector3<T>& normal) const;
+            inline Vector3<T> TransformNormal(const Vector3<T>& normal) const;
+
+            /**
+            * Applies a transformation matrix to an array of vectors, in structure of arrays form
+            *@param pX - vector x coordinates
+            *@param pY - vector y coordinates
+            *@param pZ - vector z coordinates
+            *@param count - vector count
+            *@param[out] pOutX - transformed x coordinates
+            *@param[out] pOutY - transformed y coordinates
+            *@param[out] pOutZ - transformed z coordinates
+            *@param[out] pOutW - transformed w coordinates, the input w being 1. Ignored if nullptr
+            *@note The x, y and z results are the same as the single vector transform ones. The output arrays
+            *      may be the input ones
+            */
+            inline void Transform(const T*    pX,
+                                  const T*    pY,
+                                  const T*    pZ,
+                                  std::size_t count,
+                                  T*          pOutX,
+                                  T*          pOutY,
+                                  T*          pOutZ,
+                                  T*          pOutW) const;
+
+            /**
+            * Applies a transformation matrix to an array of normals, in structure of arrays form
+            *@param pX - normal x coordinates
+            *@param pY - normal y coordinates
+            *@param pZ - normal z coordinates
+            *@param count - normal count
+            *@param[out] pOutX - transformed x coordinates
+            *@param[out] pOutY - transformed y coordinates
+            *@param[out] pOutZ - transformed z coordinates
+            *@note The results are the same as the single normal transform ones. The output arrays may be the
+            *      input ones
+            */
+            inline void TransformNormal(const T*    pX,
+                                        const T*    pY,
+                                        const T*    pZ,
+                                        std::size_t count,
+                                        T*          pOutX,
+                                        T*          pOutY,
+                                        T*          pOutZ) const;
 
             /**
             * Gets table pointer
             *@return pointer
             */
-            virtual inline const T* GetPtr() const;
+            inline const T* GetPtr() const;
     };
 
     typedef Matrix4x4<float>  Matrix4x4F;
     typedef Matrix4x4<double> Matrix4x4D;
 
+    static_assert(sizeof(Matrix4x4F) == 16 * sizeof(float),  "Matrix4x4F should only contain its values");
+    static_assert(sizeof(Matrix4x4D) == 16 * sizeof(double), "Matrix4x4D should only contain its values");
+    static_assert(std::is_trivially_copyable<Matrix4x4F>::value && std::is_standard_layout<Matrix4x4F>::value,
+                  "Matrix4x4F should be trivially copyable and have a standard layout");
+    static_assert(std::is_trivially_copyable<Matrix4x4D>::value && std::is_standard_layout<Matrix4x4D>::value,
+                  "Matrix4x4D should be trivially copyable and have a standard layout");
+
     //---------------------------------------------------------------------------
     // Matrix4x4
     //---------------------------------------------------------------------------
@@ -246,23 +305,6 @@ namespace Math
     }
     //---------------------------------------------------------------------------
     template <class T>
-    Matrix4x4<T>::Matrix4x4(const Matrix4x4& other)
-    {
-        Copy(other);
-    }
-    //---------------------------------------------------------------------------
-    template <class T>
-    Matrix4x4<T>::~Matrix4x4()
-    {}
-    //---------------------------------------------------------------------------
-    template <class T>
-    Matrix4x4<T>& Matrix4x4<T>::operator = (const Matrix4x4& other)
-    {
-        Copy(other);
-        return *this;
-    }
-    //---------------------------------------------------------------------------
-    template <class T>
     bool Matrix4x4<T>::operator == (const Matrix4x4& other)
     {
         return IsEqual(other);
@@ -499,6 +541,152 @@ namespace Math
     }
     //---------------------------------------------------------------------------
     template <class T>
+    void Matrix4x4<T>::Transform(const T*    pX,
+                                 const T*    pY,
+                                 const T*    pZ,
+                                 std::size_t count,
+                                 T*          pOutX,
+                                 T*          pOutY,
+                                 T*          pOutZ,
+                                 T*          pOutW) const
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            // read the input first, as the output may overwrite it
+            const T x = pX[i];
+            const T y = pY[i];
+            const T z = pZ[i];
+
+            pOutX[i] = x * m_Table[0][0] + y * m_Table[1][0] + z * m_Table[2][0] + m_Table[3][0];
+            pOutY[i] = x * m_Table[0][1] + y * m_Table[1][1] + z * m_Table[2][1] + m_Table[3][1];
+            pOutZ[i] = x * m_Table[0][2] + y * m_Table[1][2] + z * m_Table[2][2] + m_Table[3][2];
+
+            if (pOutW)
+                pOutW[i] = x * m_Table[0][3] + y * m_Table[1][3] + z * m_Table[2][3] + m_Table[3][3];
+        }
+    }
+    //---------------------------------------------------------------------------
+    template <class T>
+    void Matrix4x4<T>::TransformNormal(const T*    pX,
+                                       const T*    pY,
+                                       const T*    pZ,
+                                       std::size_t count,
+                                       T*          pOutX,
+                                       T*          pOutY,
+                                       T*          pOutZ) const
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            // read the input first, as the output may overwrite it
+            const T x = pX[i];
+            const T y = pY[i];
+            const T z = pZ[i];
+
+            pOutX[i] = x * m_Table[0][0] + y * m_Table[1][0] + z * m_Table[2][0];
+            pOutY[i] = x * m_Table[0][1] + y * m_Table[1][1] + z * m_Table[2][1];
+            pOutZ[i] = x * m_Table[0][2] + y * m_Table[1][2] + z * m_Table[2][2];
+        }
+    }
+    //---------------------------------------------------------------------------
+    #if MATRIX4X4_SSE
+        template <>
+        inline void Matrix4x4<float>::Transform(const float* pX,
+                                                const float* pY,
+                                                const float* pZ,
+                                                std::size_t  count,
+                                                float*       pOutX,
+                                                float*       pOutY,
+                                                float*       pOutZ,
+                                                float*       pOutW) const
+        {
+            // the multiplications and additions are executed in the same order as the single vector
+            // transform, so the results are identical
+            const std::size_t batchCount = count & ~(std::size_t)3;
+
+            for (std::size_t i = 0; i < batchCount; i += 4)
+            {
+                const __m128 x = _mm_loadu_ps(&pX[i]);
+                const __m128 y = _mm_loadu_ps(&pY[i]);
+                const __m128 z = _mm_loadu_ps(&pZ[i]);
+
+                for (std::size_t j = 0; j < 4; ++j)
+                {
+                    float* pOut = j == 0 ? pOutX : j == 1 ? pOutY : j == 2 ? pOutZ : pOutW;
+
+                    if (!pOut)
+                        continue;
+
+                    const __m128 value = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(m_Table[0][j])),
+                                                                          _mm_mul_ps(y, _mm_set1_ps(m_Table[1][j]))),
+                                                                          _mm_mul_ps(z, _mm_set1_ps(m_Table[2][j]))),
+                                                                          _mm_set1_ps(m_Table[3][j]));
+
+                    _mm_storeu_ps(&pOut[i], value);
+                }
+            }
+
+            // transform the remaining vectors one by one
+            for (std::size_t i = batchCount; i < count; ++i)
+            {
+                const float x = pX[i];
+                const float y = pY[i];
+                const float z = pZ[i];
+
+                pOutX[i] = x * m_Table[0][0] + y * m_Table[1][0] + z * m_Table[2][0] + m_Table[3][0];
+                pOutY[i] = x * m_Table[0][1] + y * m_Table[1][1] + z * m_Table[2][1] + m_Table[3][1];
+                pOutZ[i] = x * m_Table[0][2] + y * m_Table[1][2] + z * m_Table[2][2] + m_Table[3][2];
+
+                if (pOutW)
+                    pOutW[i] = x * m_Table[0][3] + y * m_Table[1][3] + z * m_Table[2][3] + m_Table[3][3];
+            }
+        }
+        //---------------------------------------------------------------------------
+        template <>
+        inline void Matrix4x4<float>::TransformNormal(const float* pX,
+                                                      const float* pY,
+                                                      const float* pZ,
+                                                      std::size_t  count,
+                                                      float*       pOutX,
+                                                      float*       pOutY,
+                                                      float*       pOutZ) const
+        {
+            // the multiplications and additions are executed in the same order as the single normal
+            // transform, so the results are identical
+            const std::size_t batchCount = count & ~(std::size_t)3;
+
+            for (std::size_t i = 0; i < batchCount; i += 4)
+            {
+                const __m128 x = _mm_loadu_ps(&pX[i]);
+                const __m128 y = _mm_loadu_ps(&pY[i]);
+                const __m128 z = _mm_loadu_ps(&pZ[i]);
+
+                for (std::size_t j = 0; j < 3; ++j)
+                {
+                    float* pOut = j == 0 ? pOutX : j == 1 ? pOutY : pOutZ;
+
+                    const __m128 value = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(m_Table[0][j])),
+                                                               _mm_mul_ps(y, _mm_set1_ps(m_Table[1][j]))),
+                                                               _mm_mul_ps(z, _mm_set1_ps(m_Table[2][j])));
+
+                    _mm_storeu_ps(&pOut[i], value);
+                }
+            }
+
+            // transform the remaining normals one by one
+            for (std::size_t i = batchCount; i < count; ++i)
+            {
+                const float x = pX[i];
+                const float y = pY[i];
+                const float z = pZ[i];
+
+                pOutX[i] = x * m_Table[0][0] + y * m_Table[1][0] + z * m_Table[2][0];
+                pOutY[i] = x * m_Table[0][1] + y * m_Table[1][1] + z * m_Table[2][1];
+                pOutZ[i] = x * m_Table[0][2] + y * m_Table[1][2] + z * m_Table[2][2];
+            }
+        }
+        //---------------------------------------------------------------------------
+    #endif
+    template <class T>
     const T* Matrix4x4<T>::GetPtr() const
     {
         return &m_Table[0][0];
@@ -0,0 +1,288 @@
+/****************************************************************************
+ * ==> MeshCache -----------------------------------------------------------*
+ ****************************************************************************
+ * Description: Binary cache of the compiled meshes                         *
+ * Developer:   Jean-Milost Reymond                                         *
+ ****************************************************************************
+ * MIT License                                                              *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files (the            *
+ * "Software"), to deal in the Software without restriction, including      *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sub-license, and/or sell copies of the Software, and to      *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+#include "MeshCache.h"
+
+// std
+#include <cstring>
+#include <fstream>
+
+// classes
+#include "WaveFront.h"
+#include "MeshOptimizer.h"
+
+using namespace Model;
+
+//---------------------------------------------------------------------------
+// Global functions
+//---------------------------------------------------------------------------
+/**
+* Rounds a cache file position up to a multiple of the alignment
+*@param position - position to align
+*@param alignment - alignment, should be a power of 2
+*@return the aligned position
+*/
+static inline std::uint64_t Align(std::uint64_t position, std::uint64_t alignment)
+{
+    return (position + alignment - 1) & ~(alignment - 1);
+}
+//---------------------------------------------------------------------------
+// MeshCache
+//---------------------------------------------------------------------------
+MeshCache::MeshCache()
+{}
+//---------------------------------------------------------------------------
+MeshCache::~MeshCache()
+{}
+//---------------------------------------------------------------------------
+bool MeshCache::Open(const std::string& fileName, Threading::ThreadPool* pThreadPool, bool build)
+{
+    Close();
+
+    IHeader header = {};
+
+    if (!GetSourceKey(fileName, header))
+        return false;
+
+    const std::string cacheName     = GetCacheFileName(fileName);
+    const IHeader*    pCachedHeader = Map(cacheName, header.m_PathHash);
+
+    // fast path, the WaveFront file didn't change since the cache was built
+    if (pCachedHeader && pCachedHeader->m_SourceSize == header.m_SourceSize &&
+        pCachedHeader->m_SourceTime == header.m_SourceTime)
+        return true;
+
+    IO::MappedFile source;
+
+    if (!source.Open(fileName))
+    {
+        Close();
+        return false;
+    }
+
+    header.m_SourceHash = Hash(source.GetData(), source.GetSize());
+
+    // if the WaveFront content remained the same, e.g. if the file was only touched, the cache is kept
+    // and only its key is refreshed
+    if (pCachedHeader && pCachedHeader->m_SourceSize == header.m_SourceSize &&
+        pCachedHeader->m_SourceHash == header.m_SourceHash)
+        return Store(cacheName, header, false);
+
+    Close();
+
+    if (!build)
+        return false;
+
+    m_BuiltMesh = MeshCompiler::Compile(WaveFront::Parse(source.GetData(),
+                                                         source.GetData() + source.GetSize(),
+                                                         pThreadPool));
+    MeshOptimizer::Optimize(m_BuiltMesh);
+
+    m_Mesh = MeshCompiler::IMeshView(m_BuiltMesh);
+
+    return Store(cacheName, header, true);
+}
+//---------------------------------------------------------------------------
+bool MeshCache::Build(const std::string& fileName, const MeshCompiler::IMesh& mesh)
+{
+    Close();
+
+    IHeader        header = {};
+    IO::MappedFile source;
+
+    if (!GetSourceKey(fileName, header) || !source.Open(fileName))
+        return false;
+
+    header.m_SourceHash = Hash(source.GetData(), source.GetSize());
+
+    m_BuiltMesh = mesh;
+    MeshOptimizer::Optimize(m_BuiltMesh);
+
+    m_Mesh = MeshCompiler::IMeshView(m_BuiltMesh);
+
+    return Store(GetCacheFileName(fileName), header, true);
+}
+//---------------------------------------------------------------------------
+void MeshCache::Close()
+{
+    m_File.Close();
+    m_BuiltMesh = MeshCompiler::IMesh();
+    m_Mesh      = MeshCompiler::IMeshView();
+}
+//---------------------------------------------------------------------------
+std::string MeshCache::GetCacheFileName(const std::string& fileName)
+{
+    return fileName + ".meshcache";
+}
+//---------------------------------------------------------------------------
+bool MeshCache::GetSourceKey(const std::string& fileName, IHeader& header)
+{
+    WIN32_FILE_ATTRIBUTE_DATA attributes;
+
+    if (!::GetFileAttributesExA(fileName.c_str(), GetFileExInfoStandard, &attributes))
+        return false;
+
+    std::memcpy(header.m_Magic, "MESH", sizeof(header.m_Magic));
+    header.m_Version    = m_Version;
+    header.m_PathHash   = Hash(fileName.data(), fileName.size());
+    header.m_SourceSize = ((std::uint64_t)attributes.nFileSizeHigh << 32) | attributes.nFileSizeLow;
+    header.m_SourceTime = ((std::uint64_t)attributes.ftLastWriteTime.dwHighDateTime << 32) |
+                                          attributes.ftLastWriteTime.dwLowDateTime;
+
+    return true;
+}
+//---------------------------------------------------------------------------
+bool MeshCache::Store(const std::string& cacheName, const IHeader& header, bool built)
+{
+    const std::string tempName = cacheName + ".tmp";
+
+    // write the new cache aside, then replace the previous one at once, so another process never maps
+    // a partial cache. Without the cache the mesh can still be used, from memory or from the previous cache
+    if (!Write(tempName, header, m_Mesh))
+    {
+        ::DeleteFileA(tempName.c_str());
+        return true;
+    }
+
+    m_File.Close();
+
+    const bool replaced = ::MoveFileExA(tempName.c_str(), cacheName.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+
+    if (!replaced)
+        ::DeleteFileA(tempName.c_str());
+
+    // map the new cache, and release the built mesh, which is no longer required
+    if ((replaced || !built) && Map(cacheName, header.m_PathHash))
+    {
+        m_BuiltMesh = MeshCompiler::IMesh();
+        return true;
+    }
+
+    if (!built)
+        return false;
+
+    m_Mesh = MeshCompiler::IMeshView(m_BuiltMesh);
+    return true;
+}
+//---------------------------------------------------------------------------
+const MeshCache::IHeader* MeshCache::Map(const std::string& cacheName, std::uint64_t pathHash)
+{
+    m_File.Close();
+    m_Mesh = MeshCompiler::IMeshView();
+
+    if (!m_File.Open(cacheName) || m_File.GetSize() < sizeof(IHeader))
+    {
+        m_File.Close();
+        return nullptr;
+    }
+
+    const IHeader*      pHeader = (const IHeader*)m_File.GetData();
+    const std::uint64_t size    = m_File.GetSize();
+
+    // check the cache version and its source, and that the streams are inside the file
+    if (std::memcmp(pHeader->m_Magic, "MESH", sizeof(pHeader->m_Magic)) ||
+        pHeader->m_Version  != m_Version                                 ||
+        pHeader->m_PathHash != pathHash                                  ||
+        pHeader->m_VertexOffset % m_Alignment                            ||
+        pHeader->m_IndexOffset  % m_Alignment                            ||
+        pHeader->m_VertexOffset > size                                   ||
+        pHeader->m_IndexOffset  > size                                   ||
+        pHeader->m_VertexCount  > (size - pHeader->m_VertexOffset) / sizeof(MeshCompiler::IVertex) ||
+        pHeader->m_IndexCount   > (size - pHeader->m_IndexOffset)  / sizeof(std::uint32_t) ||
+        pHeader->m_IndexCount   % 3)
+    {
+        m_File.Close();
+        return nullptr;
+    }
+
+    const std::uint32_t* pIndices = (const std::uint32_t*)(m_File.GetData() + pHeader->m_IndexOffset);
+
+    // check that the indices refer to existing vertices, a damaged cache is rejected and rebuilt
+    for (std::uint64_t i = 0; i < pHeader->m_IndexCount; ++i)
+        if (pIndices[i] >= pHeader->m_VertexCount)
+        {
+            m_File.Close();
+            return nullptr;
+        }
+
+    // the mesh is used in place
+    m_Mesh.m_pVertices   = (const MeshCompiler::IVertex*)(m_File.GetData() + pHeader->m_VertexOffset);
+    m_Mesh.m_pIndices    = pIndices;
+    m_Mesh.m_VertexCount = (std::size_t)pHeader->m_VertexCount;
+    m_Mesh.m_IndexCount  = (std::size_t)pHeader->m_IndexCount;
+    m_Mesh.m_Box         = pHeader->m_Box;
+    m_Mesh.m_Sphere      = pHeader->m_Sphere;
+
+    return pHeader;
+}
+//---------------------------------------------------------------------------
+bool MeshCache::Write(const std::string& cacheName, IHeader header, const MeshCompiler::IMeshView& mesh)
+{
+    std::ofstream file(cacheName, std::ios::binary | std::ios::trunc);
+
+    if (!file.is_open())
+        return false;
+
+    header.m_VertexOffset = Align(sizeof(IHeader), m_Alignment);
+    header.m_VertexCount  = mesh.m_VertexCount;
+    header.m_IndexOffset  = Align(header.m_VertexOffset + mesh.m_VertexCount * sizeof(MeshCompiler::IVertex), m_Alignment);
+    header.m_IndexCount   = mesh.m_IndexCount;
+    header.m_Box          = mesh.m_Box;
+    header.m_Sphere       = mesh.m_Sphere;
+
+    const char padding[m_Alignment] = {};
+
+    file.write((const char*)&header, sizeof(IHeader));
+    file.write(padding, header.m_VertexOffset - sizeof(IHeader));
+    file.write((const char*)mesh.m_pVertices, mesh.m_VertexCount * sizeof(MeshCompiler::IVertex));
+    file.write(padding, header.m_IndexOffset - (header.m_VertexOffset + mesh.m_VertexCount * sizeof(MeshCompiler::IVertex)));
+    file.write((const char*)mesh.m_pIndices, mesh.m_IndexCount * sizeof(std::uint32_t));
+    file.close();
+
+    return !file.fail();
+}
+//---------------------------------------------------------------------------
+std::uint64_t MeshCache::Hash(const char* pData, std::size_t size)
+{
+    std::uint64_t hash = 14695981039346656037ULL;
+    std::size_t   i    = 0;
+
+    // FNV-1a, on 8 bytes at once for speed
+    for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t))
+    {
+        std::uint64_t word;
+        std::memcpy(&word, pData + i, sizeof(word));
+        hash = (hash ^ word) * 1099511628211ULL;
+    }
+
+    for (; i < size; ++i)
+        hash = (hash ^ (unsigned char)pData[i]) * 1099511628211ULL;
+
+    return hash;
+}
+//---------------------------------------------------------------------------
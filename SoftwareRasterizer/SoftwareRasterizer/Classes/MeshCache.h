@@ -0,0 +1,172 @@
+/****************************************************************************
+ * ==> MeshCache -----------------------------------------------------------*
+ ****************************************************************************
+ * Description: Binary cache of the compiled meshes                         *
+ * Developer:   Jean-Milost Reymond                                         *
+ ****************************************************************************
+ * MIT License                                                              *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files (the            *
+ * "Software"), to deal in the Software without restriction, including      *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sub-license, and/or sell copies of the Software, and to      *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+#pragma once
+
+// std
+#include <string>
+#include <cstdint>
+
+// classes
+#include "MeshCompiler.h"
+#include "MappedFile.h"
+#include "ThreadPool.h"
+
+namespace Model
+{
+    /**
+    * Binary cache of the compiled meshes. The first time a WaveFront file is opened, it's parsed, compiled,
+    * optimized and written in a cache file beside it. The next times, the cache file is memory mapped and
+    * its content is rendered in place, without any parsing or copy
+    *@author Jean-Milost Reymond
+    */
+    class MeshCache
+    {
+        public:
+            MeshCache();
+            virtual ~MeshCache();
+
+            /**
+            * Opens the compiled mesh of a WaveFront file, rebuilding its cache file if missing or stale
+            *@param fileName - WaveFront file name
+            *@param pThreadPool - if not null, thread pool to parse the WaveFront file with, if required
+            *@param build - if false, fails instead of rebuilding the cache
+            *@return true on success, otherwise false
+            *@note The cache is stale if the WaveFront file size or modification time changed, unless its
+            *      content hash remained the same
+            */
+            bool Open(const std::string& fileName, Threading::ThreadPool* pThreadPool = nullptr, bool build = true);
+
+            /**
+            * Builds the cache of a WaveFront file from its already compiled mesh, e.g. once it was streamed,
+            * and opens it
+            *@param fileName - WaveFront file name
+            *@param mesh - WaveFront file compiled mesh, it's optimized before being cached
+            *@return true on success, otherwise false
+            */
+            bool Build(const std::string& fileName, const MeshCompiler::IMesh& mesh);
+
+            /**
+            * Closes the cache file
+            */
+            void Close();
+
+            /**
+            * Gets the cached mesh
+            *@return the cached mesh, valid until the cache is closed
+            */
+            inline const MeshCompiler::IMeshView& GetMesh() const;
+
+            /**
+            * Gets the cache file name of a WaveFront file
+            *@param fileName - WaveFront file name
+            *@return the cache file name
+            */
+            static std::string GetCacheFileName(const std::string& fileName);
+
+        private:
+            static const std::uint32_t m_Version   = 2;
+            static const std::size_t   m_Alignment = 64; // stream alignment in the cache file
+
+            /**
+            * Cache file header, followed by the vertex and index streams. The data are stored in the native
+            * byte order
+            */
+            struct IHeader
+            {
+                char                  m_Magic[4];
+                std::uint32_t         m_Version;
+                std::uint64_t         m_PathHash;     // hash of the WaveFront file name
+                std::uint64_t         m_SourceSize;   // WaveFront file size
+                std::uint64_t         m_SourceTime;   // WaveFront file last write time
+                std::uint64_t         m_SourceHash;   // WaveFront file content hash
+                std::uint64_t         m_VertexOffset; // vertex stream position in the cache file
+                std::uint64_t         m_VertexCount;
+                std::uint64_t         m_IndexOffset;  // index stream position in the cache file
+                std::uint64_t         m_IndexCount;
+                MeshCompiler::IBox    m_Box;
+                MeshCompiler::ISphere m_Sphere;
+            };
+
+            IO::MappedFile          m_File;
+            MeshCompiler::IMeshView m_Mesh;
+            MeshCompiler::IMesh     m_BuiltMesh; // mesh built from the WaveFront file, if its cache can't be written
+
+            /**
+            * Gets the cache key of a WaveFront file, except its content hash
+            *@param fileName - WaveFront file name
+            *@param[out] header - cache header to fill with the key
+            *@return true on success, otherwise false
+            */
+            static bool GetSourceKey(const std::string& fileName, IHeader& header);
+
+            /**
+            * Writes the current mesh in the cache file, and maps it
+            *@param cacheName - cache file name
+            *@param header - cache header, containing the WaveFront file key
+            *@param built - if true, the current mesh is the built one, otherwise it's the previous cache one
+            *@return true if the mesh remains available, otherwise false
+            */
+            bool Store(const std::string& cacheName, const IHeader& header, bool built);
+
+            /**
+            * Maps a cache file and validates it
+            *@param cacheName - cache file name
+            *@param pathHash - WaveFront file name hash
+            *@return the cache file header if the file is valid, otherwise nullptr
+            *@note The indices are checked against the vertex count, the vertex content isn't validated
+            */
+            const IHeader* Map(const std::string& cacheName, std::uint64_t pathHash);
+
+            /**
+            * Writes a cache file
+            *@param cacheName - cache file name
+            *@param header - header, the stream positions are set by this function
+            *@param mesh - compiled mesh to write
+            *@return true on success, otherwise false
+            */
+            static bool Write(const std::string& cacheName, IHeader header, const MeshCompiler::IMeshView& mesh);
+
+            /**
+            * Hashes data
+            *@param pData - data to hash
+            *@param size - data size in bytes
+            *@return the data hash
+            */
+            static std::uint64_t Hash(const char* pData, std::size_t size);
+    };
+
+    //---------------------------------------------------------------------------
+    // MeshCache
+    //---------------------------------------------------------------------------
+    inline const MeshCompiler::IMeshView& MeshCache::GetMesh() const
+    {
+        return m_Mesh;
+    }
+    //---------------------------------------------------------------------------
+}
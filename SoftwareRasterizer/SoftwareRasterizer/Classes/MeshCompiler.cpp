@@ -0,0 +1,250 @@
+/****************************************************************************
+ * ==> MeshCompiler --------------------------------------------------------*
+ ****************************************************************************
+ * Description: Compiles the meshes into an indexed, render ready form      *
+ * Developer:   Jean-Milost Reymond                                         *
+ ****************************************************************************
+ * MIT License                                                              *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files (the            *
+ * "Software"), to deal in the Software without restriction, including      *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sub-license, and/or sell copies of the Software, and to      *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+#include "MeshCompiler.h"
+
+// std
+#include <algorithm>
+
+using namespace Model;
+
+//---------------------------------------------------------------------------
+// Global functions
+//---------------------------------------------------------------------------
+static void ExtendSphere(MeshCompiler::ISphere& sphere, const MeshCompiler::IVertex* pVertices, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const Math::Vector3F offset   = pVertices[i].m_Position - sphere.m_Center;
+        const float          distance = offset.Length();
+
+        if (distance <= sphere.m_Radius)
+            continue;
+
+        // grow the sphere just enough to touch the vertex, keeping the opposite side in place
+        const float radius = (sphere.m_Radius + distance) * 0.5f;
+
+        sphere.m_Center += offset * ((radius - sphere.m_Radius) / distance);
+        sphere.m_Radius  = radius;
+    }
+}
+//---------------------------------------------------------------------------
+// MeshCompiler::IVertexKey
+//---------------------------------------------------------------------------
+MeshCompiler::IVertexKey::IVertexKey(const IVertex& vertex)
+{
+    std::memcpy(m_Bits, &vertex, sizeof(m_Bits));
+}
+//---------------------------------------------------------------------------
+// MeshCompiler::IVertexKeyHash
+//---------------------------------------------------------------------------
+std::size_t MeshCompiler::IVertexKeyHash::operator () (const IVertexKey& key) const
+{
+    // FNV-1a on the vertex words
+    std::uint64_t hash = 14695981039346656037ULL;
+
+    for (std::size_t i = 0; i < 8; ++i)
+        hash = (hash ^ key.m_Bits[i]) * 1099511628211ULL;
+
+    return (std::size_t)hash;
+}
+//---------------------------------------------------------------------------
+// MeshCompiler
+//---------------------------------------------------------------------------
+MeshCompiler::MeshCompiler()
+{}
+//---------------------------------------------------------------------------
+MeshCompiler::~MeshCompiler()
+{}
+//---------------------------------------------------------------------------
+void MeshCompiler::Append(const WaveFront::IMesh& mesh, std::size_t firstFace, std::size_t faceCount)
+{
+    const std::size_t firstVertex = m_Mesh.m_Vertices.size();
+    const std::size_t lastFace    = std::min(firstFace + faceCount, mesh.m_Faces.size());
+
+    // reserve for the faces of the first call, which are the whole mesh unless it's appended by chunks
+    if (m_Mesh.m_Indices.empty())
+    {
+        std::size_t triangleCount = 0;
+
+        for (std::size_t i = firstFace; i < lastFace; ++i)
+            if (mesh.m_Faces[i].m_VertexIndices.size() >= 3)
+                triangleCount += mesh.m_Faces[i].m_VertexIndices.size() - 2;
+
+        m_Mesh.m_Indices.reserve(triangleCount * 3);
+        m_VertexMap.reserve(mesh.m_Vertices.size());
+    }
+
+    for (std::size_t faceIndex = firstFace; faceIndex < lastFace; ++faceIndex)
+    {
+        const WaveFront::IFace& face = mesh.m_Faces[faceIndex];
+
+        // points and lines can't be drawn
+        if (face.m_VertexIndices.size() < 3)
+            continue;
+
+        m_FaceIndices.clear();
+
+        // get the face vertices, validating all their indices once for all
+        for (std::size_t i = 0; i < face.m_VertexIndices.size(); ++i)
+        {
+            IVertex vertex = {};
+
+            // set texture coordinate if available
+            if (i < face.m_TexCoordIndices.size() && face.m_TexCoordIndices[i] >= 0 &&
+                (std::size_t)face.m_TexCoordIndices[i] < mesh.m_TexCoords.size())
+                vertex.m_TexCoord = mesh.m_TexCoords[face.m_TexCoordIndices[i]];
+
+            // set normal if available
+            if (i < face.m_NormalIndices.size() && face.m_NormalIndices[i] >= 0 &&
+                (std::size_t)face.m_NormalIndices[i] < mesh.m_Normals.size())
+                vertex.m_Normal = mesh.m_Normals[face.m_NormalIndices[i]];
+
+            // set position, an invalid one is drawn at the origin
+            if (face.m_VertexIndices[i] >= 0 && (std::size_t)face.m_VertexIndices[i] < mesh.m_Vertices.size())
+                vertex.m_Position = mesh.m_Vertices[face.m_VertexIndices[i]];
+
+            // reuse the identical vertex if already exists
+            const auto it = m_VertexMap.emplace(IVertexKey(vertex), (std::uint32_t)m_Mesh.m_Vertices.size());
+
+            if (it.second)
+                m_Mesh.m_Vertices.push_back(vertex);
+
+            m_FaceIndices.push_back(it.first->second);
+        }
+
+        // split the face in a triangle fan
+        for (std::size_t i = 1; i + 1 < m_FaceIndices.size(); ++i)
+        {
+            m_Mesh.m_Indices.push_back(m_FaceIndices[0]);
+            m_Mesh.m_Indices.push_back(m_FaceIndices[i]);
+            m_Mesh.m_Indices.push_back(m_FaceIndices[i + 1]);
+        }
+    }
+
+    if (m_Mesh.m_Vertices.size() == firstVertex)
+        return;
+
+    // extend the bounding box with the new vertices
+    const IBox box = ComputeBox(&m_Mesh.m_Vertices[firstVertex], m_Mesh.m_Vertices.size() - firstVertex);
+
+    if (!firstVertex)
+    {
+        m_Mesh.m_Box    = box;
+        m_Mesh.m_Sphere = ComputeSphere(m_Mesh.m_Vertices.data(), m_Mesh.m_Vertices.size());
+        return;
+    }
+
+    ExtendSphere(m_Mesh.m_Sphere, &m_Mesh.m_Vertices[firstVertex], m_Mesh.m_Vertices.size() - firstVertex);
+
+    m_Mesh.m_Box.m_Min.m_X = std::min(m_Mesh.m_Box.m_Min.m_X, box.m_Min.m_X);
+    m_Mesh.m_Box.m_Min.m_Y = std::min(m_Mesh.m_Box.m_Min.m_Y, box.m_Min.m_Y);
+    m_Mesh.m_Box.m_Min.m_Z = std::min(m_Mesh.m_Box.m_Min.m_Z, box.m_Min.m_Z);
+    m_Mesh.m_Box.m_Max.m_X = std::max(m_Mesh.m_Box.m_Max.m_X, box.m_Max.m_X);
+    m_Mesh.m_Box.m_Max.m_Y = std::max(m_Mesh.m_Box.m_Max.m_Y, box.m_Max.m_Y);
+    m_Mesh.m_Box.m_Max.m_Z = std::max(m_Mesh.m_Box.m_Max.m_Z, box.m_Max.m_Z);
+}
+//---------------------------------------------------------------------------
+MeshCompiler::IMesh MeshCompiler::Compile(const WaveFront::IMesh& mesh)
+{
+    MeshCompiler compiler;
+    compiler.Append(mesh, 0, mesh.m_Faces.size());
+
+    return std::move(compiler.m_Mesh);
+}
+//---------------------------------------------------------------------------
+MeshCompiler::IBox MeshCompiler::ComputeBox(const IVertex* pVertices, std::size_t count)
+{
+    IBox box;
+
+    if (!count)
+        return box;
+
+    box.m_Min = pVertices[0].m_Position;
+    box.m_Max = pVertices[0].m_Position;
+
+    for (std::size_t i = 1; i < count; ++i)
+    {
+        const Math::Vector3F& position = pVertices[i].m_Position;
+
+        box.m_Min.m_X = std::min(box.m_Min.m_X, position.m_X);
+        box.m_Min.m_Y = std::min(box.m_Min.m_Y, position.m_Y);
+        box.m_Min.m_Z = std::min(box.m_Min.m_Z, position.m_Z);
+        box.m_Max.m_X = std::max(box.m_Max.m_X, position.m_X);
+        box.m_Max.m_Y = std::max(box.m_Max.m_Y, position.m_Y);
+        box.m_Max.m_Z = std::max(box.m_Max.m_Z, position.m_Z);
+    }
+
+    return box;
+}
+//---------------------------------------------------------------------------
+MeshCompiler::ISphere MeshCompiler::ComputeSphere(const IVertex* pVertices, std::size_t count)
+{
+    ISphere sphere;
+
+    if (!count)
+        return sphere;
+
+    // find the vertex farthest from the first one, then the vertex farthest from it
+    std::size_t first = 0;
+    std::size_t last  = 0;
+    float       max   = -1.0f;
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const float distance = (pVertices[i].m_Position - pVertices[0].m_Position).Length();
+
+        if (distance > max)
+        {
+            first = i;
+            max   = distance;
+        }
+    }
+
+    max = -1.0f;
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const float distance = (pVertices[i].m_Position - pVertices[first].m_Position).Length();
+
+        if (distance > max)
+        {
+            last = i;
+            max  = distance;
+        }
+    }
+
+    // start from the sphere whose diameter joins them, then grow it until it contains all the vertices
+    sphere.m_Center = (pVertices[first].m_Position + pVertices[last].m_Position) * 0.5f;
+    sphere.m_Radius = max * 0.5f;
+
+    ExtendSphere(sphere, pVertices, count);
+
+    return sphere;
+}
+//---------------------------------------------------------------------------
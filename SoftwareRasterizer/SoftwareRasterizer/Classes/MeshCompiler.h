@@ -0,0 +1,213 @@
+/****************************************************************************
+ * ==> MeshCompiler --------------------------------------------------------*
+ ****************************************************************************
+ * Description: Compiles the meshes into an indexed, render ready form      *
+ * Developer:   Jean-Milost Reymond                                         *
+ ****************************************************************************
+ * MIT License                                                              *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files (the            *
+ * "Software"), to deal in the Software without restriction, including      *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sub-license, and/or sell copies of the Software, and to      *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+#pragma once
+
+// std
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+
+// classes
+#include "Vector2.h"
+#include "Vector3.h"
+#include "WaveFront.h"
+
+namespace Model
+{
+    /**
+    * Mesh compiler, converts the loaded meshes into a single interleaved vertex buffer and a single
+    * triangle index buffer, which may be drawn without any further validation
+    *@author Jean-Milost Reymond
+    */
+    class MeshCompiler
+    {
+        public:
+            /**
+            * Vertex, its layout matches the OpenGL GL_T2F_N3F_V3F interleaved format
+            */
+            struct IVertex
+            {
+                Math::Vector2F m_TexCoord;
+                Math::Vector3F m_Normal;
+                Math::Vector3F m_Position;
+            };
+
+            typedef std::vector<IVertex>       IVertices;
+            typedef std::vector<std::uint32_t> IIndices;
+
+            /**
+            * Axis aligned bounding box
+            */
+            struct IBox
+            {
+                Math::Vector3F m_Min;
+                Math::Vector3F m_Max;
+            };
+
+            /**
+            * Bounding sphere
+            */
+            struct ISphere
+            {
+                Math::Vector3F m_Center;
+                float          m_Radius = 0.0f;
+            };
+
+            /**
+            * Compiled mesh, each group of 3 indices is a triangle
+            */
+            struct IMesh
+            {
+                IVertices m_Vertices;
+                IIndices  m_Indices;
+                IBox      m_Box;
+                ISphere   m_Sphere;
+            };
+
+            /**
+            * Compiled mesh view, refers to vertices and indices owned by a mesh or stored elsewhere, e.g. in
+            * a mapped file
+            */
+            struct IMeshView
+            {
+                const IVertex*       m_pVertices   = nullptr;
+                const std::uint32_t* m_pIndices    = nullptr;
+                std::size_t          m_VertexCount = 0;
+                std::size_t          m_IndexCount  = 0;
+                IBox                 m_Box;
+                ISphere              m_Sphere;
+
+                IMeshView()
+                {}
+
+                /**
+                * Constructor
+                *@param mesh - mesh to refer to, should remain unchanged while the view is used
+                */
+                IMeshView(const IMesh& mesh) :
+                    m_pVertices(mesh.m_Vertices.data()),
+                    m_pIndices(mesh.m_Indices.data()),
+                    m_VertexCount(mesh.m_Vertices.size()),
+                    m_IndexCount(mesh.m_Indices.size()),
+                    m_Box(mesh.m_Box),
+                    m_Sphere(mesh.m_Sphere)
+                {}
+            };
+
+            MeshCompiler();
+            virtual ~MeshCompiler();
+
+            /**
+            * Compiles faces, and appends them to the compiled mesh
+            *@param mesh - mesh containing the faces
+            *@param firstFace - first face to compile
+            *@param faceCount - face count to compile
+            *@note The same rules as Compile() apply. The new faces share the identical vertices already
+            *      compiled, and the bounding box and sphere are extended with the new vertices
+            */
+            void Append(const WaveFront::IMesh& mesh, std::size_t firstFace, std::size_t faceCount);
+
+            /**
+            * Gets the compiled mesh
+            *@return the compiled mesh
+            */
+            inline const IMesh& GetMesh() const;
+
+            /**
+            * Compiles a WaveFront mesh
+            *@param mesh - mesh to compile
+            *@return compiled mesh
+            *@note The faces with more than 3 vertices are split in triangle fans, those with less are ignored.
+            *      The missing or invalid texture coordinates and normals are set to zero, as well as the
+            *      invalid positions. The identical vertices are merged
+            */
+            static IMesh Compile(const WaveFront::IMesh& mesh);
+
+            /**
+            * Computes the bounding box of vertices
+            *@param pVertices - vertices
+            *@param count - vertex count
+            *@return the bounding box, empty at the origin if there is no vertex
+            */
+            static IBox ComputeBox(const IVertex* pVertices, std::size_t count);
+
+            /**
+            * Computes a bounding sphere of vertices
+            *@param pVertices - vertices
+            *@param count - vertex count
+            *@return the bounding sphere, empty at the origin if there is no vertex
+            *@note The sphere isn't the smallest one, but is usually less than 5% larger (Ritter's algorithm)
+            */
+            static ISphere ComputeSphere(const IVertex* pVertices, std::size_t count);
+
+        private:
+            /**
+            * Vertex key, the vertices are merged only if all their bits are identical
+            */
+            struct IVertexKey
+            {
+                std::uint32_t m_Bits[8];
+
+                IVertexKey(const IVertex& vertex);
+
+                inline bool operator == (const IVertexKey& other) const;
+            };
+
+            /**
+            * Vertex key hash function
+            */
+            struct IVertexKeyHash
+            {
+                std::size_t operator () (const IVertexKey& key) const;
+            };
+
+            typedef std::unordered_map<IVertexKey, std::uint32_t, IVertexKeyHash> IVertexMap;
+
+            IMesh      m_Mesh;
+            IVertexMap m_VertexMap;
+            IIndices   m_FaceIndices;
+    };
+
+    //---------------------------------------------------------------------------
+    // MeshCompiler
+    //---------------------------------------------------------------------------
+    inline const MeshCompiler::IMesh& MeshCompiler::GetMesh() const
+    {
+        return m_Mesh;
+    }
+    //---------------------------------------------------------------------------
+    inline bool MeshCompiler::IVertexKey::operator == (const IVertexKey& other) const
+    {
+        return !std::memcmp(m_Bits, other.m_Bits, sizeof(m_Bits));
+    }
+    //---------------------------------------------------------------------------
+
+    static_assert(sizeof(MeshCompiler::IVertex) == 8 * sizeof(float), "Vertex should match the GL_T2F_N3F_V3F format");
+}
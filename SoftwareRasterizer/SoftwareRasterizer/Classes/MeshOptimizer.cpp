@@ -0,0 +1,396 @@
+/****************************************************************************
+ * ==> MeshOptimizer -------------------------------------------------------*
+ ****************************************************************************
+ * Description: Reorders the mesh indices and vertices for a faster rendering*
+ * Developer:   Jean-Milost Reymond                                         *
+ ****************************************************************************
+ * MIT License                                                              *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files (the            *
+ * "Software"), to deal in the Software without restriction, including      *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sub-license, and/or sell copies of the Software, and to      *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+#include "MeshOptimizer.h"
+
+// std
+#include <algorithm>
+#include <limits>
+
+using namespace Model;
+
+//---------------------------------------------------------------------------
+// Global functions
+//---------------------------------------------------------------------------
+/**
+* FIFO vertex cache simulator. Instead of shifting a queue, each loaded vertex gets a time stamp, and it's
+* still in the cache if less than the cache size vertices were loaded since
+*/
+struct IVertexCache
+{
+    std::vector<std::size_t> m_TimeStamps;
+    std::size_t              m_Time;
+    std::size_t              m_Size;
+
+    IVertexCache(std::size_t vertexCount, std::size_t size) :
+        m_TimeStamps(vertexCount, 0),
+        m_Time(size + 1),
+        m_Size(size)
+    {}
+
+    /**
+    * Checks if a vertex is in the cache
+    *@param index - vertex index
+    *@return true if the vertex is in the cache, otherwise false
+    */
+    inline bool IsCached(std::uint32_t index) const
+    {
+        return m_Time - m_TimeStamps[index] <= m_Size;
+    }
+
+    /**
+    * Loads a vertex in the cache
+    *@param index - vertex index
+    *@return true if the vertex was missing and should be transformed, otherwise false
+    */
+    inline bool Load(std::uint32_t index)
+    {
+        if (IsCached(index))
+            return false;
+
+        m_TimeStamps[index] = m_Time++;
+        return true;
+    }
+
+    /**
+    * Empties the cache
+    */
+    inline void Flush()
+    {
+        m_Time += m_Size + 1;
+    }
+};
+//---------------------------------------------------------------------------
+// MeshOptimizer
+//---------------------------------------------------------------------------
+MeshOptimizer::IReport MeshOptimizer::Optimize(MeshCompiler::IMesh& mesh,
+                                               std::size_t          cacheSize,
+                                               float                overdrawThreshold)
+{
+    IReport report;
+    report.m_Before = Analyze(mesh, cacheSize);
+
+    OptimizeVertexCache(mesh, cacheSize);
+    OptimizeOverdraw(mesh, cacheSize, overdrawThreshold);
+    OptimizeVertexFetch(mesh);
+
+    report.m_After = Analyze(mesh, cacheSize);
+
+    return report;
+}
+//---------------------------------------------------------------------------
+void MeshOptimizer::OptimizeVertexCache(MeshCompiler::IMesh& mesh, std::size_t cacheSize)
+{
+    const std::size_t vertexCount   = mesh.m_Vertices.size();
+    const std::size_t triangleCount = mesh.m_Indices.size() / 3;
+
+    if (!triangleCount)
+        return;
+
+    const MeshCompiler::IIndices& indices = mesh.m_Indices;
+
+    // build the triangles adjacent to each vertex, one vertex range after the other
+    std::vector<std::uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+    std::vector<std::uint32_t> adjacency(triangleCount * 3);
+
+    for (std::size_t i = 0; i < triangleCount * 3; ++i)
+        ++adjacencyOffsets[indices[i] + 1];
+
+    for (std::size_t i = 0; i < vertexCount; ++i)
+        adjacencyOffsets[i + 1] += adjacencyOffsets[i];
+
+    // the live triangle count is first used as insertion cursor, which leaves it to the vertex triangle count
+    std::vector<std::uint32_t> liveCount(vertexCount, 0);
+
+    for (std::size_t i = 0; i < triangleCount * 3; ++i)
+        adjacency[adjacencyOffsets[indices[i]] + liveCount[indices[i]]++] = (std::uint32_t)(i / 3);
+
+    IVertexCache               cache(vertexCount, cacheSize);
+    std::vector<bool>          emitted(triangleCount, false);
+    std::vector<std::uint32_t> deadEnds;
+    std::vector<std::uint32_t> candidates;
+    MeshCompiler::IIndices     result;
+    std::size_t                cursor  = 0;
+    std::int64_t               fanning = 0;
+
+    deadEnds.reserve(triangleCount * 3);
+    result.reserve(triangleCount * 3);
+
+    while (fanning >= 0)
+    {
+        candidates.clear();
+
+        // emit all the triangles not yet drawn around the fanning vertex
+        for (std::uint32_t i = adjacencyOffsets[(std::size_t)fanning]; i < adjacencyOffsets[(std::size_t)fanning + 1]; ++i)
+        {
+            const std::uint32_t triangle = adjacency[i];
+
+            if (emitted[triangle])
+                continue;
+
+            for (std::size_t j = 0; j < 3; ++j)
+            {
+                const std::uint32_t index = indices[(std::size_t)triangle * 3 + j];
+
+                result.push_back(index);
+                deadEnds.push_back(index);
+                candidates.push_back(index);
+                --liveCount[index];
+                cache.Load(index);
+            }
+
+            emitted[triangle] = true;
+        }
+
+        fanning = -1;
+
+        // the next fanning vertex is the oldest candidate which will still be in the cache after all
+        // its remaining triangles are drawn, or the most recent one if none
+        std::int64_t bestPriority = -1;
+
+        for (const std::uint32_t candidate : candidates)
+        {
+            if (!liveCount[candidate])
+                continue;
+
+            std::int64_t priority = 0;
+            const std::size_t age = cache.m_Time - cache.m_TimeStamps[candidate];
+
+            if (age + 2 * liveCount[candidate] <= cacheSize)
+                priority = (std::int64_t)age;
+
+            if (priority > bestPriority)
+            {
+                bestPriority = priority;
+                fanning      = candidate;
+            }
+        }
+
+        if (fanning >= 0)
+            continue;
+
+        // dead end, restart from the most recently used vertex which still has triangles to draw
+        while (!deadEnds.empty() && fanning < 0)
+        {
+            const std::uint32_t index = deadEnds.back();
+            deadEnds.pop_back();
+
+            if (liveCount[index])
+                fanning = index;
+        }
+
+        // otherwise from the next vertex which still has triangles to draw
+        while (cursor < vertexCount && fanning < 0)
+        {
+            if (liveCount[cursor])
+                fanning = (std::int64_t)cursor;
+
+            ++cursor;
+        }
+    }
+
+    mesh.m_Indices.swap(result);
+}
+//---------------------------------------------------------------------------
+void MeshOptimizer::OptimizeOverdraw(MeshCompiler::IMesh& mesh, std::size_t cacheSize, float threshold)
+{
+    const std::size_t triangleCount = mesh.m_Indices.size() / 3;
+
+    if (triangleCount < 2)
+        return;
+
+    const MeshCompiler::IIndices& indices = mesh.m_Indices;
+    const float                   maxACMR = Analyze(mesh, cacheSize).m_ACMR * threshold;
+
+    // the clusters start where the triangle order jumps to another mesh area, i.e. where all the triangle
+    // vertices are missing from the cache
+    std::vector<std::uint32_t> hardBoundaries;
+    IVertexCache               cache(mesh.m_Vertices.size(), cacheSize);
+
+    for (std::size_t i = 0; i < triangleCount; ++i)
+    {
+        std::size_t misses = 0;
+
+        for (std::size_t j = 0; j < 3; ++j)
+            misses += cache.Load(indices[i * 3 + j]);
+
+        if (!i || misses == 3)
+            hardBoundaries.push_back((std::uint32_t)i);
+    }
+
+    hardBoundaries.push_back((std::uint32_t)triangleCount);
+
+    // split the clusters further, each time their own cache miss ratio is low enough. As each cluster is
+    // measured from an empty cache, it may be moved anywhere without exceeding the maximum ratio
+    std::vector<std::uint32_t> clusters;
+
+    for (std::size_t i = 0; i + 1 < hardBoundaries.size(); ++i)
+    {
+        std::size_t start  = hardBoundaries[i];
+        std::size_t misses = 0;
+
+        clusters.push_back((std::uint32_t)start);
+        cache.Flush();
+
+        for (std::size_t triangle = start; triangle < hardBoundaries[i + 1]; ++triangle)
+        {
+            for (std::size_t j = 0; j < 3; ++j)
+                misses += cache.Load(indices[triangle * 3 + j]);
+
+            const std::size_t next = triangle + 1;
+
+            if (next < hardBoundaries[i + 1] && (float)misses <= maxACMR * (float)(next - start))
+            {
+                start  = next;
+                misses = 0;
+
+                clusters.push_back((std::uint32_t)start);
+                cache.Flush();
+            }
+        }
+    }
+
+    clusters.push_back((std::uint32_t)triangleCount);
+
+    const std::size_t clusterCount = clusters.size() - 1;
+
+    // mesh center
+    Math::Vector3F center;
+
+    for (const auto& vertex : mesh.m_Vertices)
+        center += vertex.m_Position;
+
+    if (!mesh.m_Vertices.empty())
+        center /= (float)mesh.m_Vertices.size();
+
+    // the clusters facing away from the mesh center are likely on the outer surface, where they occlude
+    // the others, so they are drawn first
+    std::vector<float>         sortKeys(clusterCount);
+    std::vector<std::uint32_t> order(clusterCount);
+
+    for (std::size_t i = 0; i < clusterCount; ++i)
+    {
+        Math::Vector3F centroid;
+        Math::Vector3F normal;
+        float          area = 0.0f;
+
+        for (std::size_t triangle = clusters[i]; triangle < clusters[i + 1]; ++triangle)
+        {
+            const Math::Vector3F& v0 = mesh.m_Vertices[indices[triangle * 3]].m_Position;
+            const Math::Vector3F& v1 = mesh.m_Vertices[indices[triangle * 3 + 1]].m_Position;
+            const Math::Vector3F& v2 = mesh.m_Vertices[indices[triangle * 3 + 2]].m_Position;
+
+            // the cross product length is twice the triangle area, use it to weight the triangles
+            const Math::Vector3F cross        = (v1 - v0).Cross(v2 - v0);
+            const float          triangleArea = cross.Length();
+
+            centroid += (v0 + v1 + v2) * (triangleArea / 3.0f);
+            normal   += cross;
+            area     += triangleArea;
+        }
+
+        const float normalLength = normal.Length();
+
+        if (area > 0.0f && normalLength > 0.0f)
+            sortKeys[i] = (centroid / area - center).Dot(normal / normalLength);
+        else
+            sortKeys[i] = -std::numeric_limits<float>::max();
+
+        order[i] = (std::uint32_t)i;
+    }
+
+    std::stable_sort(order.begin(),
+                     order.end(),
+                     [&sortKeys](std::uint32_t a, std::uint32_t b) { return sortKeys[a] > sortKeys[b]; });
+
+    MeshCompiler::IIndices result;
+    result.reserve(indices.size());
+
+    for (const std::uint32_t cluster : order)
+        result.insert(result.end(), indices.begin() + clusters[cluster] * 3, indices.begin() + clusters[cluster + 1] * 3);
+
+    mesh.m_Indices.swap(result);
+}
+//---------------------------------------------------------------------------
+void MeshOptimizer::OptimizeVertexFetch(MeshCompiler::IMesh& mesh)
+{
+    const std::uint32_t unused = std::numeric_limits<std::uint32_t>::max();
+
+    std::vector<std::uint32_t> remap(mesh.m_Vertices.size(), unused);
+    MeshCompiler::IVertices    vertices;
+
+    vertices.reserve(mesh.m_Vertices.size());
+
+    // number the vertices in the order of their first use
+    for (auto& index : mesh.m_Indices)
+    {
+        if (remap[index] == unused)
+        {
+            remap[index] = (std::uint32_t)vertices.size();
+            vertices.push_back(mesh.m_Vertices[index]);
+        }
+
+        index = remap[index];
+    }
+
+    mesh.m_Vertices.swap(vertices);
+}
+//---------------------------------------------------------------------------
+MeshOptimizer::IStatistics MeshOptimizer::Analyze(const MeshCompiler::IMesh& mesh, std::size_t cacheSize)
+{
+    IStatistics statistics;
+
+    const std::size_t triangleCount = mesh.m_Indices.size() / 3;
+
+    if (!triangleCount)
+        return statistics;
+
+    IVertexCache      cache(mesh.m_Vertices.size(), cacheSize);
+    std::vector<bool> used(mesh.m_Vertices.size(), false);
+    std::size_t       misses    = 0;
+    std::size_t       usedCount = 0;
+
+    for (std::size_t i = 0; i < triangleCount * 3; ++i)
+    {
+        const std::uint32_t index = mesh.m_Indices[i];
+
+        misses += cache.Load(index);
+
+        if (!used[index])
+        {
+            used[index] = true;
+            ++usedCount;
+        }
+    }
+
+    statistics.m_ACMR = (float)misses / (float)triangleCount;
+    statistics.m_ATVR = (float)misses / (float)usedCount;
+
+    return statistics;
+}
+//---------------------------------------------------------------------------
@@ -0,0 +1,112 @@
+/****************************************************************************
+ * ==> MeshOptimizer -------------------------------------------------------*
+ ****************************************************************************
+ * Description: Reorders the mesh indices and vertices for a faster rendering*
+ * Developer:   Jean-Milost Reymond                                         *
+ ****************************************************************************
+ * MIT License                                                              *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files (the            *
+ * "Software"), to deal in the Software without restriction, including      *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sub-license, and/or sell copies of the Software, and to      *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+#pragma once
+
+// std
+#include <cstddef>
+
+// classes
+#include "MeshCompiler.h"
+
+namespace Model
+{
+    /**
+    * Mesh optimizer, reorders the compiled mesh triangles to reuse the transformed vertices and to limit
+    * the overdraw, then the vertices in the order they are fetched. The mesh content isn't changed, only
+    * its order. Meant to be applied once, before the mesh is rendered many times
+    *@author Jean-Milost Reymond
+    */
+    class MeshOptimizer
+    {
+        public:
+            static const std::size_t m_DefaultCacheSize = 16;
+
+            /**
+            * Vertex cache statistics, for a FIFO cache
+            */
+            struct IStatistics
+            {
+                float m_ACMR = 0.0f; // average cache miss ratio, transformed vertices per triangle (0.5 at best, 3 at worst)
+                float m_ATVR = 0.0f; // average transform to vertex ratio, transformed vertices per vertex (1 at best)
+            };
+
+            /**
+            * Optimization report
+            */
+            struct IReport
+            {
+                IStatistics m_Before;
+                IStatistics m_After;
+            };
+
+            /**
+            * Runs all the optimization stages on a mesh
+            *@param[in, out] mesh - mesh to optimize
+            *@param cacheSize - simulated vertex cache size
+            *@param overdrawThreshold - vertex cache miss ratio the overdraw optimization may add, 1.05 allows 5% more
+            *@return the vertex cache statistics, before and after the optimization
+            */
+            static IReport Optimize(MeshCompiler::IMesh& mesh,
+                                    std::size_t          cacheSize         = m_DefaultCacheSize,
+                                    float                overdrawThreshold = 1.05f);
+
+            /**
+            * Reorders the triangles to reuse the vertices still in the cache, with the Tipsify algorithm
+            *@param[in, out] mesh - mesh to optimize
+            *@param cacheSize - simulated vertex cache size
+            */
+            static void OptimizeVertexCache(MeshCompiler::IMesh& mesh, std::size_t cacheSize = m_DefaultCacheSize);
+
+            /**
+            * Splits the triangles in clusters, and reorders them to draw the occluding ones first
+            *@param[in, out] mesh - mesh to optimize, should be already optimized for the vertex cache
+            *@param cacheSize - simulated vertex cache size
+            *@param threshold - vertex cache miss ratio the clusters may add, 1.05 allows 5% more
+            *@note The clusters are sorted by how much they face away from the mesh center, which doesn't depend
+            *      on the point of view
+            */
+            static void OptimizeOverdraw(MeshCompiler::IMesh& mesh,
+                                         std::size_t          cacheSize = m_DefaultCacheSize,
+                                         float                threshold = 1.05f);
+
+            /**
+            * Reorders the vertices in the order the triangles use them, and removes the unused ones
+            *@param[in, out] mesh - mesh to optimize
+            */
+            static void OptimizeVertexFetch(MeshCompiler::IMesh& mesh);
+
+            /**
+            * Simulates a FIFO vertex cache to measure how many vertices are transformed to draw a mesh
+            *@param mesh - mesh to analyze
+            *@param cacheSize - simulated vertex cache size
+            *@return the vertex cache statistics
+            */
+            static IStatistics Analyze(const MeshCompiler::IMesh& mesh, std::size_t cacheSize = m_DefaultCacheSize);
+    };
+}
@@ -0,0 +1,229 @@
+/****************************************************************************
+ * ==> MeshQuantizer -------------------------------------------------------*
+ ****************************************************************************
+ * Description: Compacts the compiled meshes with quantized vertices        *
+ * Developer:   Jean-Milost Reymond                                         *
+ ****************************************************************************
+ * MIT License                                                              *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files (the            *
+ * "Software"), to deal in the Software without restriction, including      *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sub-license, and/or sell copies of the Software, and to      *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+#include "MeshQuantizer.h"
+
+using namespace Model;
+
+//---------------------------------------------------------------------------
+// Global functions
+//---------------------------------------------------------------------------
+static inline std::uint16_t QuantizeUnorm(float value, float min, float extent)
+{
+    if (extent <= 0.0f)
+        return 0;
+
+    const float normalized = std::min(std::max((value - min) / extent, 0.0f), 1.0f);
+
+    return (std::uint16_t)(normalized * 65535.0f + 0.5f);
+}
+//---------------------------------------------------------------------------
+static inline std::int16_t QuantizeSnorm(float value)
+{
+    const float clamped = std::min(std::max(value, -1.0f), 1.0f);
+
+    return (std::int16_t)std::lround(clamped * 32767.0f);
+}
+//---------------------------------------------------------------------------
+// MeshQuantizer::IVertexKey
+//---------------------------------------------------------------------------
+MeshQuantizer::IVertexKey::IVertexKey(const IVertex& vertex)
+{
+    std::memcpy(m_Bits, &vertex, sizeof(m_Bits));
+}
+//---------------------------------------------------------------------------
+// MeshQuantizer::IVertexKeyHash
+//---------------------------------------------------------------------------
+std::size_t MeshQuantizer::IVertexKeyHash::operator () (const IVertexKey& key) const
+{
+    // FNV-1a on the vertex words
+    std::uint64_t hash = 14695981039346656037ULL;
+
+    for (std::size_t i = 0; i < 2; ++i)
+        hash = (hash ^ key.m_Bits[i]) * 1099511628211ULL;
+
+    return (std::size_t)hash;
+}
+//---------------------------------------------------------------------------
+// MeshQuantizer
+//---------------------------------------------------------------------------
+MeshQuantizer::IMesh MeshQuantizer::Quantize(const MeshCompiler::IMeshView& mesh)
+{
+    IMesh quantized;
+    quantized.m_Box    = mesh.m_Box;
+    quantized.m_Sphere = mesh.m_Sphere;
+
+    const Math::Vector3F extent = mesh.m_Box.m_Max - mesh.m_Box.m_Min;
+
+    // 65535 steps between the box min and max, the flat axes keep a zero scale
+    quantized.m_Scale = Math::Vector3F(extent.m_X / 65535.0f, extent.m_Y / 65535.0f, extent.m_Z / 65535.0f);
+
+    quantized.m_Vertices.reserve(mesh.m_VertexCount);
+    quantized.m_Indices.reserve(mesh.m_IndexCount);
+
+    std::vector<std::uint32_t> remap(mesh.m_VertexCount);
+
+    IVertexMap vertexMap;
+    vertexMap.reserve(mesh.m_VertexCount);
+
+    for (std::size_t i = 0; i < mesh.m_VertexCount; ++i)
+    {
+        const MeshCompiler::IVertex& source = mesh.m_pVertices[i];
+
+        IVertex vertex;
+        vertex.m_Position[0] = QuantizeUnorm(source.m_Position.m_X, mesh.m_Box.m_Min.m_X, extent.m_X);
+        vertex.m_Position[1] = QuantizeUnorm(source.m_Position.m_Y, mesh.m_Box.m_Min.m_Y, extent.m_Y);
+        vertex.m_Position[2] = QuantizeUnorm(source.m_Position.m_Z, mesh.m_Box.m_Min.m_Z, extent.m_Z);
+        vertex.m_TexCoord[0] = FloatToHalf(source.m_TexCoord.m_X);
+        vertex.m_TexCoord[1] = FloatToHalf(source.m_TexCoord.m_Y);
+        vertex.m_Padding     = 0;
+        EncodeNormal(source.m_Normal, vertex.m_Normal);
+
+        // weld the vertices which can no longer be distinguished once quantized
+        const auto result = vertexMap.emplace(IVertexKey(vertex), (std::uint32_t)quantized.m_Vertices.size());
+
+        if (result.second)
+            quantized.m_Vertices.push_back(vertex);
+
+        remap[i] = result.first->second;
+    }
+
+    for (std::size_t i = 0; i < mesh.m_IndexCount; ++i)
+        quantized.m_Indices.push_back(remap[mesh.m_pIndices[i]]);
+
+    quantized.m_Vertices.shrink_to_fit();
+
+    return quantized;
+}
+//---------------------------------------------------------------------------
+MeshCompiler::IVertex MeshQuantizer::Dequantize(const IVertex& vertex, const IMesh& mesh)
+{
+    MeshCompiler::IVertex result;
+
+    result.m_Position.m_X = mesh.m_Box.m_Min.m_X + (float)vertex.m_Position[0] * mesh.m_Scale.m_X;
+    result.m_Position.m_Y = mesh.m_Box.m_Min.m_Y + (float)vertex.m_Position[1] * mesh.m_Scale.m_Y;
+    result.m_Position.m_Z = mesh.m_Box.m_Min.m_Z + (float)vertex.m_Position[2] * mesh.m_Scale.m_Z;
+    result.m_TexCoord.m_X = HalfToFloat(vertex.m_TexCoord[0]);
+    result.m_TexCoord.m_Y = HalfToFloat(vertex.m_TexCoord[1]);
+    result.m_Normal       = DecodeNormal(vertex.m_Normal);
+
+    return result;
+}
+//---------------------------------------------------------------------------
+Math::Matrix4x4F MeshQuantizer::GetDequantizationMatrix(const IMesh& mesh)
+{
+    // scale the quantized position, then translate it to the box min
+    Math::Matrix4x4F matrix = Math::Matrix4x4F::Identity();
+    matrix.m_Table[0][0] = mesh.m_Scale.m_X;
+    matrix.m_Table[1][1] = mesh.m_Scale.m_Y;
+    matrix.m_Table[2][2] = mesh.m_Scale.m_Z;
+    matrix.m_Table[3][0] = mesh.m_Box.m_Min.m_X;
+    matrix.m_Table[3][1] = mesh.m_Box.m_Min.m_Y;
+    matrix.m_Table[3][2] = mesh.m_Box.m_Min.m_Z;
+
+    return matrix;
+}
+//---------------------------------------------------------------------------
+std::uint16_t MeshQuantizer::FloatToHalf(float value)
+{
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    const std::uint16_t sign     = (std::uint16_t)((bits >> 16) & 0x8000);
+    const std::int32_t  exponent = (std::int32_t)((bits >> 23) & 0xFF) - 127 + 15;
+          std::uint32_t mantissa = bits & 0x7FFFFF;
+
+    // infinite or NaN
+    if (((bits >> 23) & 0xFF) == 0xFF)
+        return sign | 0x7C00 | (mantissa ? 0x200 : 0);
+
+    // too large, becomes infinite
+    if (exponent >= 0x1F)
+        return sign | 0x7C00;
+
+    if (exponent <= 0)
+    {
+        // too small even for a denormalized half, becomes zero
+        if (exponent < -10)
+            return sign;
+
+        // denormalized, shift the mantissa with its implicit bit
+        mantissa |= 0x800000;
+
+        const std::uint32_t shift     = (std::uint32_t)(14 - exponent);
+        const std::uint32_t half      = 1u << (shift - 1);
+        const std::uint32_t remainder = mantissa & ((1u << shift) - 1);
+              std::uint32_t result    = mantissa >> shift;
+
+        // round to the nearest, ties to even
+        if (remainder > half || (remainder == half && (result & 1)))
+            ++result;
+
+        return sign | (std::uint16_t)result;
+    }
+
+    std::uint32_t result = ((std::uint32_t)exponent << 10) | (mantissa >> 13);
+
+    const std::uint32_t remainder = mantissa & 0x1FFF;
+
+    // round to the nearest, ties to even. A carry in the exponent is still right, up to infinite
+    if (remainder > 0x1000 || (remainder == 0x1000 && (result & 1)))
+        ++result;
+
+    return sign | (std::uint16_t)result;
+}
+//---------------------------------------------------------------------------
+void MeshQuantizer::EncodeNormal(const Math::Vector3F& normal, std::int16_t* encoded)
+{
+    const float length = std::fabs(normal.m_X) + std::fabs(normal.m_Y) + std::fabs(normal.m_Z);
+
+    if (length <= 0.0f)
+    {
+        encoded[0] = 0;
+        encoded[1] = 0;
+        return;
+    }
+
+    // project the normal on the octahedron
+    float x = normal.m_X / length;
+    float y = normal.m_Y / length;
+
+    // fold the lower hemisphere over the octahedron diagonals
+    if (normal.m_Z < 0.0f)
+    {
+        const float foldedX = (1.0f - std::fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+        const float foldedY = (1.0f - std::fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+
+        x = foldedX;
+        y = foldedY;
+    }
+
+    encoded[0] = QuantizeSnorm(x);
+    encoded[1] = QuantizeSnorm(y);
+}
+//---------------------------------------------------------------------------
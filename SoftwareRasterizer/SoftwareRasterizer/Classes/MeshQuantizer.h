@@ -0,0 +1,210 @@
+/****************************************************************************
+ * ==> MeshQuantizer -------------------------------------------------------*
+ ****************************************************************************
+ * Description: Compacts the compiled meshes with quantized vertices        *
+ * Developer:   Jean-Milost Reymond                                         *
+ ****************************************************************************
+ * MIT License                                                              *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files (the            *
+ * "Software"), to deal in the Software without restriction, including      *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sub-license, and/or sell copies of the Software, and to      *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+#pragma once
+
+// std
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+// classes
+#include "Vector3.h"
+#include "Matrix4x4.h"
+#include "MeshCompiler.h"
+
+namespace Model
+{
+    /**
+    * Mesh quantizer, compacts the compiled mesh vertices from 32 to 16 bytes. The positions are stored on
+    * 16 bits relatively to the mesh bounding box, the normals on 2x16 bits with an octahedral encoding,
+    * and the texture coordinates as half floats
+    *@author Jean-Milost Reymond
+    */
+    class MeshQuantizer
+    {
+        public:
+            /**
+            * Quantized vertex
+            */
+            struct IVertex
+            {
+                std::uint16_t m_Position[3]; // position in the bounding box, from 0 (min) to 65535 (max)
+                std::uint16_t m_TexCoord[2]; // half floats
+                std::int16_t  m_Normal[2];   // octahedral normal, from -32767 (-1) to 32767 (1)
+                std::uint16_t m_Padding;
+            };
+
+            typedef std::vector<IVertex> IVertices;
+
+            /**
+            * Quantized mesh, each group of 3 indices is a triangle
+            */
+            struct IMesh
+            {
+                IVertices              m_Vertices;
+                MeshCompiler::IIndices m_Indices;
+                MeshCompiler::IBox     m_Box;
+                MeshCompiler::ISphere  m_Sphere;
+                Math::Vector3F         m_Scale; // position = box min + quantized position * scale
+            };
+
+            /**
+            * Quantizes a compiled mesh
+            *@param mesh - mesh to quantize
+            *@return quantized mesh
+            *@note The vertices which become identical once quantized are welded. A zero normal can't be
+            *      encoded, it becomes the (0, 0, 1) one
+            */
+            static IMesh Quantize(const MeshCompiler::IMeshView& mesh);
+
+            /**
+            * Dequantizes a vertex
+            *@param vertex - vertex to dequantize
+            *@param mesh - mesh containing the vertex
+            *@return dequantized vertex
+            */
+            static MeshCompiler::IVertex Dequantize(const IVertex& vertex, const IMesh& mesh);
+
+            /**
+            * Gets the matrix converting the quantized positions to the mesh space
+            *@param mesh - quantized mesh
+            *@return the dequantization matrix, to combine before the model matrix
+            */
+            static Math::Matrix4x4F GetDequantizationMatrix(const IMesh& mesh);
+
+            /**
+            * Converts a float to a half float, rounded to the nearest
+            *@param value - value to convert
+            *@return the half float
+            */
+            static std::uint16_t FloatToHalf(float value);
+
+            /**
+            * Converts a half float to a float
+            *@param value - half float to convert
+            *@return the float value
+            */
+            static inline float HalfToFloat(std::uint16_t value);
+
+            /**
+            * Encodes a normal with the octahedral encoding
+            *@param normal - normal to encode
+            *@param[out] encoded - encoded normal (array of 2 items)
+            */
+            static void EncodeNormal(const Math::Vector3F& normal, std::int16_t* encoded);
+
+            /**
+            * Decodes a normal encoded with the octahedral encoding
+            *@param encoded - encoded normal (array of 2 items)
+            *@return the normal
+            */
+            static inline Math::Vector3F DecodeNormal(const std::int16_t* encoded);
+
+        private:
+            /**
+            * Quantized vertex key, the vertex bits compared as 2 words
+            */
+            struct IVertexKey
+            {
+                std::uint64_t m_Bits[2];
+
+                IVertexKey(const IVertex& vertex);
+
+                inline bool operator == (const IVertexKey& other) const
+                {
+                    return m_Bits[0] == other.m_Bits[0] && m_Bits[1] == other.m_Bits[1];
+                }
+            };
+
+            /**
+            * Quantized vertex key hash
+            */
+            struct IVertexKeyHash
+            {
+                std::size_t operator () (const IVertexKey& key) const;
+            };
+
+            typedef std::unordered_map<IVertexKey, std::uint32_t, IVertexKeyHash> IVertexMap;
+    };
+
+    static_assert(sizeof(MeshQuantizer::IVertex) == 16, "Quantized vertex should be 16 bytes");
+
+    //---------------------------------------------------------------------------
+    // MeshQuantizer
+    //---------------------------------------------------------------------------
+    inline float MeshQuantizer::HalfToFloat(std::uint16_t value)
+    {
+        const std::uint32_t sign     = (std::uint32_t)(value & 0x8000) << 16;
+        const std::uint32_t exponent = (value >> 10) & 0x1F;
+        const std::uint32_t mantissa =  value        & 0x3FF;
+
+        std::uint32_t bits;
+
+        if (exponent == 0x1F)
+            // infinite or NaN
+            bits = sign | 0x7F800000 | (mantissa << 13);
+        else
+        if (exponent)
+            // normalized, rebias the exponent from 15 to 127
+            bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+        else
+        if (mantissa)
+        {
+            // denormalized, the value is mantissa * 2^-24, which is exact as a float
+            const float result = (float)mantissa * (1.0f / 16777216.0f);
+            return sign ? -result : result;
+        }
+        else
+            bits = sign;
+
+        float result;
+        std::memcpy(&result, &bits, sizeof(result));
+
+        return result;
+    }
+    //---------------------------------------------------------------------------
+    inline Math::Vector3F MeshQuantizer::DecodeNormal(const std::int16_t* encoded)
+    {
+        Math::Vector3F normal((float)encoded[0] * (1.0f / 32767.0f), (float)encoded[1] * (1.0f / 32767.0f), 0.0f);
+
+        // unfold the lower hemisphere, which was folded over the octahedron diagonals
+        normal.m_Z = 1.0f - std::fabs(normal.m_X) - std::fabs(normal.m_Y);
+
+        const float fold = std::max(-normal.m_Z, 0.0f);
+
+        normal.m_X += normal.m_X >= 0.0f ? -fold : fold;
+        normal.m_Y += normal.m_Y >= 0.0f ? -fold : fold;
+
+        return normal.Normalize();
+    }
+    //---------------------------------------------------------------------------
+}
@@ -0,0 +1,551 @@
+/****************************************************************************
+ * ==> MeshSimplifier ------------------------------------------------------*
+ ****************************************************************************
+ * Description: Simplifies the compiled meshes, to build their levels of detail*
+ * Developer:   Jean-Milost Reymond                                         *
+ ****************************************************************************
+ * MIT License                                                              *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files (the            *
+ * "Software"), to deal in the Software without restriction, including      *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sub-license, and/or sell copies of the Software, and to      *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+#include "MeshSimplifier.h"
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace Model;
+
+//---------------------------------------------------------------------------
+// Global functions
+//---------------------------------------------------------------------------
+static inline Math::Vector3F GetTriangleNormal(const Math::Vector3F& v1, const Math::Vector3F& v2, const Math::Vector3F& v3)
+{
+    return (v2 - v1).Cross(v3 - v1);
+}
+//---------------------------------------------------------------------------
+// MeshSimplifier::IQuadric
+//---------------------------------------------------------------------------
+void MeshSimplifier::IQuadric::AddPlane(const Math::Vector3F& normal, const Math::Vector3F& point, float weight)
+{
+    const double a = normal.m_X;
+    const double b = normal.m_Y;
+    const double c = normal.m_Z;
+    const double d = -(double)normal.Dot(point);
+    const double w = weight;
+
+    m_A00 += w * a * a;
+    m_A11 += w * b * b;
+    m_A22 += w * c * c;
+    m_A10 += w * b * a;
+    m_A20 += w * c * a;
+    m_A21 += w * c * b;
+    m_B0  += w * a * d;
+    m_B1  += w * b * d;
+    m_B2  += w * c * d;
+    m_C   += w * d * d;
+    m_W   += w;
+}
+//---------------------------------------------------------------------------
+void MeshSimplifier::IQuadric::Add(const IQuadric& other)
+{
+    m_A00 += other.m_A00;
+    m_A11 += other.m_A11;
+    m_A22 += other.m_A22;
+    m_A10 += other.m_A10;
+    m_A20 += other.m_A20;
+    m_A21 += other.m_A21;
+    m_B0  += other.m_B0;
+    m_B1  += other.m_B1;
+    m_B2  += other.m_B2;
+    m_C   += other.m_C;
+    m_W   += other.m_W;
+}
+//---------------------------------------------------------------------------
+float MeshSimplifier::IQuadric::GetError(const Math::Vector3F& point) const
+{
+    if (m_W <= 0.0)
+        return 0.0f;
+
+    const double x = point.m_X;
+    const double y = point.m_Y;
+    const double z = point.m_Z;
+
+    // p^T * A * p + 2 * b^T * p + c
+    const double error = m_A00 * x * x + m_A11 * y * y + m_A22 * z * z +
+                         2.0 * (m_A10 * x * y + m_A20 * x * z + m_A21 * y * z) +
+                         2.0 * (m_B0 * x + m_B1 * y + m_B2 * z) +
+                         m_C;
+
+    return (float)std::max(error / m_W, 0.0);
+}
+//---------------------------------------------------------------------------
+// MeshSimplifier::IEdges
+//---------------------------------------------------------------------------
+void MeshSimplifier::IEdges::Build(const MeshCompiler::IIndices& indices, std::size_t vertexCount)
+{
+    // group the directed edges by start vertex, with a counting sort
+    m_Offsets.assign(vertexCount + 1, 0);
+    m_Targets.resize(indices.size());
+
+    for (std::size_t i = 0; i < indices.size(); ++i)
+        ++m_Offsets[indices[i] + 1];
+
+    for (std::size_t i = 0; i < vertexCount; ++i)
+        m_Offsets[i + 1] += m_Offsets[i];
+
+    std::vector<std::uint32_t> fill(m_Offsets.begin(), m_Offsets.end() - 1);
+
+    for (std::size_t i = 0; i < indices.size(); i += 3)
+        for (std::size_t j = 0; j < 3; ++j)
+            m_Targets[fill[indices[i + j]]++] = indices[i + (j + 1) % 3];
+}
+//---------------------------------------------------------------------------
+bool MeshSimplifier::IEdges::Has(std::uint32_t start, std::uint32_t end) const
+{
+    for (std::uint32_t i = m_Offsets[start]; i < m_Offsets[start + 1]; ++i)
+        if (m_Targets[i] == end)
+            return true;
+
+    return false;
+}
+//---------------------------------------------------------------------------
+bool MeshSimplifier::IEdges::IsOpen(std::uint32_t vertex1, std::uint32_t vertex2) const
+{
+    return Has(vertex1, vertex2) != Has(vertex2, vertex1);
+}
+//---------------------------------------------------------------------------
+// MeshSimplifier
+//---------------------------------------------------------------------------
+MeshCompiler::IIndices MeshSimplifier::Simplify(const MeshCompiler::IMeshView& mesh,
+                                                      std::size_t              targetIndexCount,
+                                                      float                    maxError,
+                                                      float*                   pError)
+{
+    // border and seam edges are weighted more than the faces, to keep them in place
+    const float         borderWeight = 10.0f;
+    const std::uint32_t unused       = std::numeric_limits<std::uint32_t>::max();
+    const std::size_t   vertexCount  = mesh.m_VertexCount;
+
+    MeshCompiler::IIndices indices(mesh.m_pIndices, mesh.m_pIndices + mesh.m_IndexCount);
+
+    float resultError = 0.0f;
+
+    if (pError)
+        *pError = 0.0f;
+
+    if (indices.size() <= targetIndexCount)
+        return indices;
+
+    // the compiled vertices are split wherever the texture coordinates or the normals differ, so find the
+    // vertices sharing the same position. The remap links them to the first one, and the wedge links them
+    // in a ring
+    std::vector<std::uint32_t> remap(vertexCount);
+    std::vector<std::uint32_t> wedge(vertexCount);
+
+    {
+        std::vector<std::uint32_t> order(vertexCount);
+
+        for (std::size_t i = 0; i < vertexCount; ++i)
+            order[i] = (std::uint32_t)i;
+
+        std::sort(order.begin(), order.end(), [&mesh](std::uint32_t a, std::uint32_t b)
+        {
+            const Math::Vector3F& pa = mesh.m_pVertices[a].m_Position;
+            const Math::Vector3F& pb = mesh.m_pVertices[b].m_Position;
+
+            if (pa.m_X != pb.m_X)
+                return pa.m_X < pb.m_X;
+
+            if (pa.m_Y != pb.m_Y)
+                return pa.m_Y < pb.m_Y;
+
+            if (pa.m_Z != pb.m_Z)
+                return pa.m_Z < pb.m_Z;
+
+            return a < b;
+        });
+
+        for (std::size_t i = 0; i < vertexCount; ++i)
+        {
+            const std::uint32_t vertex = order[i];
+
+            wedge[vertex] = vertex;
+
+            if (i && mesh.m_pVertices[order[i - 1]].m_Position.m_X == mesh.m_pVertices[vertex].m_Position.m_X
+                  && mesh.m_pVertices[order[i - 1]].m_Position.m_Y == mesh.m_pVertices[vertex].m_Position.m_Y
+                  && mesh.m_pVertices[order[i - 1]].m_Position.m_Z == mesh.m_pVertices[vertex].m_Position.m_Z)
+            {
+                const std::uint32_t first = remap[order[i - 1]];
+
+                remap[vertex] = first;
+                wedge[vertex] = wedge[first];
+                wedge[first]  = vertex;
+            }
+            else
+                remap[vertex] = vertex;
+        }
+    }
+
+    IEdges edges;
+    edges.Build(indices, vertexCount);
+
+    // classify the vertices from their open edges. A seam vertex has exactly 2 wedges, each one on a side
+    // of the seam, whose open edges lead to the same positions
+    std::vector<IEVertexKind> kinds(vertexCount);
+
+    {
+        // the open edge leaving and reaching each vertex, the vertex itself if there are several
+        std::vector<std::uint32_t> openOut(vertexCount, unused);
+        std::vector<std::uint32_t> openIn (vertexCount, unused);
+
+        for (std::uint32_t i = 0; i < (std::uint32_t)vertexCount; ++i)
+            for (std::uint32_t j = edges.m_Offsets[i]; j < edges.m_Offsets[i + 1]; ++j)
+            {
+                const std::uint32_t target = edges.m_Targets[j];
+
+                if (edges.Has(target, i))
+                    continue;
+
+                openOut[i]     = openOut[i]     == unused ? target : i;
+                openIn[target] = openIn[target] == unused ? i      : target;
+            }
+
+        for (std::uint32_t i = 0; i < (std::uint32_t)vertexCount; ++i)
+        {
+            const std::uint32_t twin = wedge[i];
+
+            // a vertex whose triangle fan is closed is independent from the other wedges, which belong to
+            // another surface only touching it
+            if (openOut[i] == unused && openIn[i] == unused)
+                kinds[i] = IEVertexKind::Manifold;
+            else
+            if (twin == i)
+            {
+                if (openOut[i] != unused && openOut[i] != i && openIn[i] != unused && openIn[i] != i)
+                    kinds[i] = IEVertexKind::Border;
+                else
+                    kinds[i] = IEVertexKind::Locked;
+            }
+            else
+            if (wedge[twin] == i                                                                          &&
+                openOut[i]    != unused && openOut[i]    != i    && openIn[i]    != unused && openIn[i]    != i &&
+                openOut[twin] != unused && openOut[twin] != twin && openIn[twin] != unused && openIn[twin] != twin &&
+                remap[openOut[i]] == remap[openIn[twin]] && remap[openIn[i]] == remap[openOut[twin]])
+                kinds[i] = IEVertexKind::Seam;
+            else
+                kinds[i] = IEVertexKind::Locked;
+        }
+    }
+
+    // accumulate the face planes, and the planes orthogonal to the faces along the open edges, on the
+    // first vertex of each position
+    std::vector<IQuadric> quadrics(vertexCount);
+
+    for (std::size_t i = 0; i < indices.size(); i += 3)
+    {
+        const Math::Vector3F& v1     = mesh.m_pVertices[indices[i]].m_Position;
+        const Math::Vector3F& v2     = mesh.m_pVertices[indices[i + 1]].m_Position;
+        const Math::Vector3F& v3     = mesh.m_pVertices[indices[i + 2]].m_Position;
+        const Math::Vector3F  normal = GetTriangleNormal(v1, v2, v3);
+        const float           area   = normal.Length();
+
+        if (area == 0.0f)
+            continue;
+
+        const Math::Vector3F unitNormal = normal / area;
+
+        for (std::size_t j = 0; j < 3; ++j)
+            quadrics[remap[indices[i + j]]].AddPlane(unitNormal, v1, area);
+
+        for (std::size_t j = 0; j < 3; ++j)
+        {
+            const std::uint32_t start = indices[i + j];
+            const std::uint32_t end   = indices[i + (j + 1) % 3];
+
+            if (!edges.IsOpen(start, end))
+                continue;
+
+            const Math::Vector3F edge   = mesh.m_pVertices[end].m_Position - mesh.m_pVertices[start].m_Position;
+            const float          length = edge.Length();
+
+            if (length == 0.0f)
+                continue;
+
+            const Math::Vector3F edgeNormal = edge.Cross(unitNormal) / length;
+            const float          weight     = length * length * borderWeight;
+
+            quadrics[remap[start]].AddPlane(edgeNormal, mesh.m_pVertices[start].m_Position, weight);
+            quadrics[remap[end]].AddPlane  (edgeNormal, mesh.m_pVertices[start].m_Position, weight);
+        }
+    }
+
+    const float maxSquaredError = maxError * maxError;
+
+    std::vector<ICollapse>     collapses;
+    std::vector<std::uint32_t> collapseRemap(vertexCount);
+    std::vector<std::uint8_t>  collapseLocked(vertexCount);
+    std::vector<std::uint32_t> adjacencyOffsets;
+    std::vector<std::uint32_t> adjacency;
+
+    // finds, for a seam vertex collapsed along its seam, the wedge its twin should be collapsed to
+    auto getTwinTarget = [&](std::uint32_t source, std::uint32_t target) -> std::uint32_t
+    {
+        const std::uint32_t twin = wedge[source];
+
+        for (std::uint32_t i = wedge[target]; ; i = wedge[i])
+        {
+            if (i != target && edges.IsOpen(twin, i))
+                return i;
+
+            if (i == target)
+                return unused;
+        }
+    };
+
+    // checks if a vertex may be collapsed on another
+    auto canCollapse = [&](std::uint32_t source, std::uint32_t target) -> bool
+    {
+        // a vertex linked to several wedges of the target position would join them, tearing the seam
+        for (std::uint32_t i = wedge[target]; i != target; i = wedge[i])
+            if (edges.Has(source, i) || edges.Has(i, source))
+                return false;
+
+        switch (kinds[source])
+        {
+            case IEVertexKind::Manifold: return true;
+            case IEVertexKind::Border:   return edges.IsOpen(source, target);
+            case IEVertexKind::Seam:     return edges.IsOpen(source, target) && getTwinTarget(source, target) != unused;
+            default:                     return false;
+        }
+    };
+
+    // checks if collapsing a vertex, with its twin if on a seam, on another position flips any triangle
+    auto hasFlip = [&](std::uint32_t source, std::uint32_t target) -> bool
+    {
+        const Math::Vector3F& position   = mesh.m_pVertices[target].m_Position;
+        const std::size_t     wedgeCount = kinds[source] == IEVertexKind::Seam ? 2 : 1;
+              std::uint32_t   vertex     = source;
+
+        for (std::size_t n = 0; n < wedgeCount; ++n)
+        {
+            for (std::uint32_t i = adjacencyOffsets[vertex]; i < adjacencyOffsets[vertex + 1]; ++i)
+            {
+                const std::uint32_t* pTriangle = &indices[adjacency[i] * 3];
+
+                if (remap[pTriangle[0]] == remap[target] ||
+                    remap[pTriangle[1]] == remap[target] ||
+                    remap[pTriangle[2]] == remap[target])
+                    continue;
+
+                Math::Vector3F positions[3];
+
+                for (std::size_t j = 0; j < 3; ++j)
+                    positions[j] = mesh.m_pVertices[pTriangle[j]].m_Position;
+
+                const Math::Vector3F before = GetTriangleNormal(positions[0], positions[1], positions[2]);
+
+                for (std::size_t j = 0; j < 3; ++j)
+                    if (pTriangle[j] == vertex)
+                        positions[j] = position;
+
+                const Math::Vector3F after = GetTriangleNormal(positions[0], positions[1], positions[2]);
+
+                if (before.Dot(after) <= 0.0f)
+                    return true;
+            }
+
+            vertex = wedge[vertex];
+        }
+
+        return false;
+    };
+
+    // collapse the cheapest edges by passes, each vertex being collapsed or changed once per pass, until
+    // the target or the max error is reached
+    while (indices.size() > targetIndexCount)
+    {
+        const std::size_t triangleCount = indices.size() / 3;
+
+        // list the triangles using each vertex, with a counting sort
+        adjacencyOffsets.assign(vertexCount + 1, 0);
+        adjacency.resize(indices.size());
+
+        for (std::size_t i = 0; i < indices.size(); ++i)
+            ++adjacencyOffsets[indices[i] + 1];
+
+        for (std::size_t i = 0; i < vertexCount; ++i)
+            adjacencyOffsets[i + 1] += adjacencyOffsets[i];
+
+        {
+            std::vector<std::uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+
+            for (std::size_t i = 0; i < indices.size(); ++i)
+                adjacency[fill[indices[i]]++] = (std::uint32_t)(i / 3);
+        }
+
+        // rank the edges, collapsing each one in its cheapest allowed direction
+        collapses.clear();
+
+        for (std::size_t i = 0; i < indices.size(); i += 3)
+            for (std::size_t j = 0; j < 3; ++j)
+            {
+                const std::uint32_t v1 = indices[i + j];
+                const std::uint32_t v2 = indices[i + (j + 1) % 3];
+
+                // the inner edges are shared by 2 triangles, rank them once
+                if (remap[v1] > remap[v2] && edges.Has(v2, v1))
+                    continue;
+
+                const bool  canCollapse1 = canCollapse(v1, v2);
+                const bool  canCollapse2 = canCollapse(v2, v1);
+                const float error1       = canCollapse1 ? quadrics[remap[v1]].GetError(mesh.m_pVertices[v2].m_Position) : 0.0f;
+                const float error2       = canCollapse2 ? quadrics[remap[v2]].GetError(mesh.m_pVertices[v1].m_Position) : 0.0f;
+
+                if (canCollapse1 && (!canCollapse2 || error1 <= error2))
+                    collapses.push_back({v1, v2, error1});
+                else
+                if (canCollapse2)
+                    collapses.push_back({v2, v1, error2});
+            }
+
+        std::sort(collapses.begin(), collapses.end(), [](const ICollapse& a, const ICollapse& b)
+        {
+            return a.m_Error < b.m_Error;
+        });
+
+        for (std::size_t i = 0; i < vertexCount; ++i)
+            collapseRemap[i] = (std::uint32_t)i;
+
+        std::fill(collapseLocked.begin(), collapseLocked.end(), 0);
+
+        // an inner edge collapse removes 2 triangles, don't overshoot the target. As the collapses lock their
+        // neighborhood, the cheapest ones may not be enough to reach it, so don't collapse the edges much
+        // more expensive than the one which would, wait for the next pass to rank them again
+        const std::size_t maxCollapses  = std::max((triangleCount - targetIndexCount / 3) / 2, (std::size_t)1);
+        const float       errorLimit    = collapses.empty() ?
+                0.0f : std::min(collapses[std::min(maxCollapses, collapses.size()) - 1].m_Error * 2.25f, maxSquaredError);
+              std::size_t collapseCount = 0;
+
+        for (std::size_t i = 0; i < collapses.size() && collapseCount < maxCollapses; ++i)
+        {
+            const ICollapse& collapse = collapses[i];
+
+            if (collapse.m_Error > errorLimit)
+                break;
+
+            const std::uint32_t source = collapse.m_Source;
+            const std::uint32_t target = collapse.m_Target;
+
+            if (collapseLocked[remap[source]] || collapseLocked[remap[target]])
+                continue;
+
+            if (hasFlip(source, target))
+                continue;
+
+            collapseRemap[source] = target;
+
+            // a seam vertex twin is collapsed along the other side of the seam
+            if (kinds[source] == IEVertexKind::Seam)
+                collapseRemap[wedge[source]] = getTwinTarget(source, target);
+
+            quadrics[remap[target]].Add(quadrics[remap[source]]);
+
+            // lock the source neighborhood, its triangles are changing
+            const std::size_t   wedgeCount = kinds[source] == IEVertexKind::Seam ? 2 : 1;
+                  std::uint32_t vertex     = source;
+
+            for (std::size_t n = 0; n < wedgeCount; ++n)
+            {
+                for (std::uint32_t j = adjacencyOffsets[vertex]; j < adjacencyOffsets[vertex + 1]; ++j)
+                    for (std::size_t k = 0; k < 3; ++k)
+                        collapseLocked[remap[indices[adjacency[j] * 3 + k]]] = 1;
+
+                vertex = wedge[vertex];
+            }
+
+            resultError = std::max(resultError, collapse.m_Error);
+            ++collapseCount;
+        }
+
+        if (!collapseCount)
+            break;
+
+        // remap the indices and remove the degenerated triangles
+        std::size_t writeIndex = 0;
+
+        for (std::size_t i = 0; i < indices.size(); i += 3)
+        {
+            const std::uint32_t v1 = collapseRemap[indices[i]];
+            const std::uint32_t v2 = collapseRemap[indices[i + 1]];
+            const std::uint32_t v3 = collapseRemap[indices[i + 2]];
+
+            if (remap[v1] == remap[v2] || remap[v2] == remap[v3] || remap[v3] == remap[v1])
+                continue;
+
+            indices[writeIndex++] = v1;
+            indices[writeIndex++] = v2;
+            indices[writeIndex++] = v3;
+        }
+
+        indices.resize(writeIndex);
+        edges.Build(indices, vertexCount);
+    }
+
+    if (pError)
+        *pError = std::sqrt(resultError);
+
+    return indices;
+}
+//---------------------------------------------------------------------------
+MeshSimplifier::ILods MeshSimplifier::BuildLods(const MeshCompiler::IMeshView& mesh,
+                                                      std::size_t              levelCount,
+                                                      float                    ratio)
+{
+    ILods lods(1);
+    lods[0].m_Indices.assign(mesh.m_pIndices, mesh.m_pIndices + mesh.m_IndexCount);
+
+    MeshCompiler::IMeshView view = mesh;
+
+    for (std::size_t i = 0; i < levelCount; ++i)
+    {
+        const ILevel&     previous    = lods.back();
+        const std::size_t targetCount = (std::size_t)((float)(previous.m_Indices.size() / 3) * ratio) * 3;
+
+        view.m_pIndices   = previous.m_Indices.data();
+        view.m_IndexCount = previous.m_Indices.size();
+
+        ILevel level;
+        level.m_Indices = Simplify(view, targetCount, 1.0e30f, &level.m_Error);
+
+        // stop if the mesh can't be simplified further
+        if (level.m_Indices.size() >= previous.m_Indices.size())
+            break;
+
+        // each level is simplified from the previous one, so their errors add up
+        level.m_Error += previous.m_Error;
+
+        lods.push_back(std::move(level));
+    }
+
+    return lods;
+}
@@ -0,0 +1,176 @@
+/****************************************************************************
+ * ==> MeshSimplifier ------------------------------------------------------*
+ ****************************************************************************
+ * Description: Simplifies the compiled meshes, to build their levels of detail*
+ * Developer:   Jean-Milost Reymond                                         *
+ ****************************************************************************
+ * MIT License                                                              *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files (the            *
+ * "Software"), to deal in the Software without restriction, including      *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sub-license, and/or sell copies of the Software, and to      *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+#pragma once
+
+// std
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// classes
+#include "Vector3.h"
+#include "MeshCompiler.h"
+
+namespace Model
+{
+    /**
+    * Mesh simplifier, removes the compiled mesh triangles whose removal changes the surface the least, by
+    * collapsing their edges ordered by quadric error metrics (QEM). The vertices are kept unchanged, the
+    * simplified meshes only have less indices referring to them, so all the levels of detail share the same
+    * vertices. The texture seams, the normal discontinuities and the open borders are preserved
+    *@author Jean-Milost Reymond
+    */
+    class MeshSimplifier
+    {
+        public:
+            /**
+            * Level of detail
+            */
+            struct ILevel
+            {
+                MeshCompiler::IIndices m_Indices;
+                float                  m_Error = 0.0f; // max distance from the source mesh surface, in mesh units
+            };
+
+            typedef std::vector<ILevel> ILods;
+
+            /**
+            * Simplifies a mesh
+            *@param mesh - mesh to simplify
+            *@param targetIndexCount - index count to reach, may not be reached if the mesh can't be simplified more
+            *@param maxError - max distance from the mesh surface, in mesh units
+            *@param[out] pError - if not nullptr, the distance from the mesh surface, in mesh units
+            *@return the simplified mesh indices, referring to the mesh vertices
+            */
+            static MeshCompiler::IIndices Simplify(const MeshCompiler::IMeshView& mesh,
+                                                         std::size_t              targetIndexCount,
+                                                         float                    maxError = 1.0e30f,
+                                                         float*                   pError   = nullptr);
+
+            /**
+            * Builds the levels of detail of a mesh
+            *@param mesh - mesh
+            *@param levelCount - level count to build, after the source mesh one
+            *@param ratio - triangle ratio kept from a level to the next one
+            *@return the levels of detail, the first one being the source mesh
+            *@note Each level is simplified from the previous one, so 4 levels with a 0.5 ratio keep 50, 25, 12.5
+            *      and 6.25% of the triangles
+            */
+            static ILods BuildLods(const MeshCompiler::IMeshView& mesh,
+                                         std::size_t              levelCount = 4,
+                                         float                    ratio      = 0.5f);
+
+        private:
+            /**
+            * Vertex kind, defining the edges it may be collapsed along
+            */
+            enum class IEVertexKind
+            {
+                Manifold, // inside the surface, may be collapsed along any edge
+                Border,   // on an open border, may be collapsed along the border only
+                Seam,     // on a texture or normal seam, may be collapsed along the seam only, with its twin vertex
+                Locked    // on a seam end, a border and a seam or any other complex place, never collapsed
+            };
+
+            /**
+            * Quadric, sum of the squared distances to weighted planes
+            */
+            struct IQuadric
+            {
+                double m_A00 = 0.0, m_A11 = 0.0, m_A22 = 0.0;
+                double m_A10 = 0.0, m_A20 = 0.0, m_A21 = 0.0;
+                double m_B0  = 0.0, m_B1  = 0.0, m_B2  = 0.0;
+                double m_C   = 0.0;
+                double m_W   = 0.0; // plane weight sum
+
+                /**
+                * Adds a plane to the quadric
+                *@param normal - plane normal, normalized
+                *@param point - point on the plane
+                *@param weight - plane weight
+                */
+                void AddPlane(const Math::Vector3F& normal, const Math::Vector3F& point, float weight);
+
+                /**
+                * Adds another quadric
+                *@param other - quadric to add
+                */
+                void Add(const IQuadric& other);
+
+                /**
+                * Gets the weighted average of the squared distances from a point to the planes
+                *@param point - point
+                *@return the squared distance
+                */
+                float GetError(const Math::Vector3F& point) const;
+            };
+
+            /**
+            * Edge collapse
+            */
+            struct ICollapse
+            {
+                std::uint32_t m_Source;
+                std::uint32_t m_Target;
+                float         m_Error;
+            };
+
+            /**
+            * Directed edges of a triangle list, grouped by start vertex
+            */
+            struct IEdges
+            {
+                std::vector<std::uint32_t> m_Offsets;
+                std::vector<std::uint32_t> m_Targets;
+
+                /**
+                * Builds the edges
+                *@param indices - triangle list indices
+                *@param vertexCount - vertex count
+                */
+                void Build(const MeshCompiler::IIndices& indices, std::size_t vertexCount);
+
+                /**
+                * Checks if an edge exists
+                *@param start - edge start vertex
+                *@param end - edge end vertex
+                *@return true if the edge exists, otherwise false
+                */
+                bool Has(std::uint32_t start, std::uint32_t end) const;
+
+                /**
+                * Checks if an edge is open, i.e. exists in a direction only
+                *@param vertex1 - edge first vertex
+                *@param vertex2 - edge second vertex
+                *@return true if the edge is open, otherwise false
+                */
+                bool IsOpen(std::uint32_t vertex1, std::uint32_t vertex2) const;
+            };
+    };
+}
@@ -0,0 +1,150 @@
+/****************************************************************************
+ * ==> MeshStreamer --------------------------------------------------------*
+ ****************************************************************************
+ * Description: Progressive WaveFront loader                                *
+ * Developer:   Jean-Milost Reymond                                         *
+ ****************************************************************************
+ * MIT License                                                              *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files (the            *
+ * "Software"), to deal in the Software without restriction, including      *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sub-license, and/or sell copies of the Software, and to      *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+#include "MeshStreamer.h"
+
+using namespace Model;
+
+//---------------------------------------------------------------------------
+// MeshStreamer
+//---------------------------------------------------------------------------
+MeshStreamer::MeshStreamer()
+{}
+//---------------------------------------------------------------------------
+MeshStreamer::~MeshStreamer()
+{}
+//---------------------------------------------------------------------------
+bool MeshStreamer::Open(const std::string& fileName)
+{
+    Close();
+
+    m_File.open(fileName, std::ios::binary);
+
+    return m_File.is_open();
+}
+//---------------------------------------------------------------------------
+void MeshStreamer::Close()
+{
+    if (m_File.is_open())
+        m_File.close();
+
+    m_File.clear();
+    m_Pending.clear();
+
+    m_Source   = WaveFront::IMesh();
+    m_Compiler = MeshCompiler();
+    m_Complete = false;
+}
+//---------------------------------------------------------------------------
+std::size_t MeshStreamer::Read(std::size_t maxSize)
+{
+    if (!m_File.is_open() || m_Complete)
+        return 0;
+
+    m_Buffer.resize(maxSize);
+
+    m_File.read(m_Buffer.data(), (std::streamsize)maxSize);
+
+    const std::size_t size = (std::size_t)m_File.gcount();
+
+    // the file end was reached
+    if (!size)
+    {
+        m_File.close();
+        return Finish();
+    }
+
+    return Feed(m_Buffer.data(), size);
+}
+//---------------------------------------------------------------------------
+std::size_t MeshStreamer::Feed(const char* pData, std::size_t size)
+{
+    if (m_Complete || !size)
+        return 0;
+
+    // find the last complete line
+    std::size_t lineEnd = size;
+
+    while (lineEnd && pData[lineEnd - 1] != '\n')
+        --lineEnd;
+
+    // no line was completed, keep the part for later
+    if (!lineEnd)
+    {
+        m_Pending.append(pData, size);
+        return 0;
+    }
+
+    std::size_t faceCount;
+
+    // complete the previous part last line first
+    if (!m_Pending.empty())
+    {
+        m_Pending.append(pData, lineEnd);
+        faceCount = Parse(m_Pending.data(), m_Pending.data() + m_Pending.size());
+        m_Pending.clear();
+    }
+    else
+        faceCount = Parse(pData, pData + lineEnd);
+
+    m_Pending.append(pData + lineEnd, size - lineEnd);
+
+    return faceCount;
+}
+//---------------------------------------------------------------------------
+std::size_t MeshStreamer::Finish()
+{
+    if (m_Complete)
+        return 0;
+
+    const std::size_t faceCount = Parse(m_Pending.data(), m_Pending.data() + m_Pending.size());
+
+    m_Pending.clear();
+    m_Pending.shrink_to_fit();
+    m_Buffer.clear();
+    m_Buffer.shrink_to_fit();
+
+    m_Complete = true;
+
+    return faceCount;
+}
+//---------------------------------------------------------------------------
+std::size_t MeshStreamer::Parse(const char* pBegin, const char* pEnd)
+{
+    WaveFront::Append(pBegin, pEnd, m_Source);
+
+    const std::size_t faceCount = m_Source.m_Faces.size();
+
+    // compile the new faces, which are no longer required once compiled. The vertices, texture coordinates
+    // and normals are kept, as the next faces may still refer to them
+    m_Compiler.Append(m_Source, 0, faceCount);
+    m_Source.m_Faces.clear();
+
+    return faceCount;
+}
+//---------------------------------------------------------------------------
@@ -0,0 +1,132 @@
+/****************************************************************************
+ * ==> MeshStreamer --------------------------------------------------------*
+ ****************************************************************************
+ * Description: Progressive WaveFront loader                                *
+ * Developer:   Jean-Milost Reymond                                         *
+ ****************************************************************************
+ * MIT License                                                              *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files (the            *
+ * "Software"), to deal in the Software without restriction, including      *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sub-license, and/or sell copies of the Software, and to      *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+#pragma once
+
+// std
+#include <string>
+#include <vector>
+#include <fstream>
+
+// classes
+#include "WaveFront.h"
+#include "MeshCompiler.h"
+
+namespace Model
+{
+    /**
+    * Progressive WaveFront loader, parses and compiles a WaveFront content part by part, so the mesh may be
+    * rendered while it grows, instead of waiting until the whole content is loaded
+    *@author Jean-Milost Reymond
+    */
+    class MeshStreamer
+    {
+        public:
+            static const std::size_t m_DefaultPartSize = 256 * 1024;
+
+            MeshStreamer();
+            virtual ~MeshStreamer();
+
+            /**
+            * Opens a WaveFront file to read progressively
+            *@param fileName - WaveFront file name
+            *@return true on success, otherwise false
+            */
+            bool Open(const std::string& fileName);
+
+            /**
+            * Closes the file and clears the mesh
+            */
+            void Close();
+
+            /**
+            * Reads and parses the next part of the opened file
+            *@param maxSize - maximum size to read, in bytes
+            *@return the number of faces completed by this part
+            *@note The stream is complete once the file end is reached
+            */
+            std::size_t Read(std::size_t maxSize = m_DefaultPartSize);
+
+            /**
+            * Parses the next part of a WaveFront content, e.g. while it's downloaded
+            *@param pData - content part
+            *@param size - content part size, in bytes
+            *@return the number of faces completed by this part
+            *@note The last incomplete line is kept until the next part or Finish() completes it
+            */
+            std::size_t Feed(const char* pData, std::size_t size);
+
+            /**
+            * Parses the last line, once the whole content was fed
+            *@return the number of faces completed by the last line
+            */
+            std::size_t Finish();
+
+            /**
+            * Checks if the whole content was parsed
+            *@return true if the whole content was parsed, otherwise false
+            */
+            inline bool IsComplete() const;
+
+            /**
+            * Gets the mesh compiled so far
+            *@return the compiled mesh, which grows with each part
+            */
+            inline const MeshCompiler::IMesh& GetMesh() const;
+
+        private:
+            std::ifstream     m_File;
+            std::vector<char> m_Buffer;
+            std::string       m_Pending;  // incomplete last line of the previous part
+            WaveFront::IMesh  m_Source;   // all the items parsed so far, except the faces already compiled
+            MeshCompiler      m_Compiler;
+            bool              m_Complete = false;
+
+            /**
+            * Parses complete lines, and compiles their faces
+            *@param pBegin - lines start
+            *@param pEnd - lines end, excluded
+            *@return the number of new faces
+            */
+            std::size_t Parse(const char* pBegin, const char* pEnd);
+    };
+
+    //---------------------------------------------------------------------------
+    // MeshStreamer
+    //---------------------------------------------------------------------------
+    inline bool MeshStreamer::IsComplete() const
+    {
+        return m_Complete;
+    }
+    //---------------------------------------------------------------------------
+    inline const MeshCompiler::IMesh& MeshStreamer::GetMesh() const
+    {
+        return m_Compiler.GetMesh();
+    }
+    //---------------------------------------------------------------------------
+}
@@ -0,0 +1,267 @@
+/****************************************************************************
+ * ==> MeshletBuilder ------------------------------------------------------*
+ ****************************************************************************
+ * Description: Splits the compiled meshes in small clusters of triangles   *
+ * Developer:   Jean-Milost Reymond                                         *
+ ****************************************************************************
+ * MIT License                                                              *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files (the            *
+ * "Software"), to deal in the Software without restriction, including      *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sub-license, and/or sell copies of the Software, and to      *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+#include "MeshletBuilder.h"
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace Model;
+
+//---------------------------------------------------------------------------
+// MeshletBuilder
+//---------------------------------------------------------------------------
+MeshletBuilder::IMeshlets MeshletBuilder::Build(const MeshCompiler::IMeshView& mesh,
+                                                      std::size_t              maxVertices,
+                                                      std::size_t              maxTriangles)
+{
+    // the meshlet vertices are indexed on 8 bits
+    maxVertices  = std::min(std::max(maxVertices, (std::size_t)3), (std::size_t)256);
+    maxTriangles = std::max(maxTriangles, (std::size_t)1);
+
+    const std::size_t   triangleCount = mesh.m_IndexCount / 3;
+    const std::uint32_t unused        = std::numeric_limits<std::uint32_t>::max();
+
+    IMeshlets meshlets;
+
+    if (!triangleCount)
+        return meshlets;
+
+    // list the triangles using each vertex, with a counting sort
+    std::vector<std::uint32_t> adjacencyOffsets(mesh.m_VertexCount + 1, 0);
+    std::vector<std::uint32_t> adjacency(triangleCount * 3);
+
+    for (std::size_t i = 0; i < triangleCount * 3; ++i)
+        ++adjacencyOffsets[mesh.m_pIndices[i] + 1];
+
+    for (std::size_t i = 0; i < mesh.m_VertexCount; ++i)
+        adjacencyOffsets[i + 1] += adjacencyOffsets[i];
+
+    {
+        std::vector<std::uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+
+        for (std::size_t i = 0; i < triangleCount * 3; ++i)
+            adjacency[fill[mesh.m_pIndices[i]]++] = (std::uint32_t)(i / 3);
+    }
+
+    std::vector<Math::Vector3F> normals(triangleCount);
+
+    for (std::size_t i = 0; i < triangleCount; ++i)
+        normals[i] = GetNormal(mesh.m_pVertices[mesh.m_pIndices[i * 3]].m_Position,
+                               mesh.m_pVertices[mesh.m_pIndices[i * 3 + 1]].m_Position,
+                               mesh.m_pVertices[mesh.m_pIndices[i * 3 + 2]].m_Position);
+
+    std::vector<bool>                  emitted(triangleCount, false);
+    std::vector<std::uint32_t>         localIndices(mesh.m_VertexCount, unused);
+    std::vector<MeshCompiler::IVertex> positions;
+
+    meshlets.m_Meshlets.reserve(triangleCount / maxTriangles + 1);
+    meshlets.m_Vertices.reserve(mesh.m_VertexCount + mesh.m_VertexCount / 2);
+    meshlets.m_Triangles.reserve(triangleCount * 3);
+
+    IMeshlet       meshlet;
+    Math::Vector3F normalSum;
+    std::size_t    seed = 0;
+
+    // closes the current meshlet, and starts the next one
+    const auto closeMeshlet = [&]()
+    {
+        ComputeBounds(mesh, meshlets, meshlet, positions);
+
+        for (std::size_t i = meshlet.m_VertexOffset; i < meshlets.m_Vertices.size(); ++i)
+            localIndices[meshlets.m_Vertices[i]] = unused;
+
+        meshlets.m_Meshlets.push_back(meshlet);
+
+        meshlet                  = IMeshlet();
+        meshlet.m_VertexOffset   = (std::uint32_t)meshlets.m_Vertices.size();
+        meshlet.m_TriangleOffset = (std::uint32_t)meshlets.m_Triangles.size();
+        normalSum                = Math::Vector3F();
+    };
+
+    while (true)
+    {
+        std::size_t best      = triangleCount;
+        float       bestScore = std::numeric_limits<float>::max();
+
+        // search the best neighbor triangle, among the ones sharing a vertex with the meshlet
+        if (meshlet.m_TriangleCount)
+        {
+            const Math::Vector3F axis = normalSum.Normalize();
+
+            for (std::size_t i = meshlet.m_VertexOffset; i < meshlets.m_Vertices.size(); ++i)
+            {
+                const std::uint32_t vertex = meshlets.m_Vertices[i];
+
+                for (std::uint32_t j = adjacencyOffsets[vertex]; j < adjacencyOffsets[vertex + 1]; ++j)
+                {
+                    const std::uint32_t triangle = adjacency[j];
+
+                    if (emitted[triangle])
+                        continue;
+
+                    std::size_t newVertices = 0;
+
+                    for (std::size_t k = 0; k < 3; ++k)
+                        if (localIndices[mesh.m_pIndices[triangle * 3 + k]] == unused)
+                            ++newVertices;
+
+                    if (meshlet.m_VertexCount + newVertices > maxVertices)
+                        continue;
+
+                    // prefer the triangles adding no vertex, then the ones keeping the normal cone narrow
+                    const float score = (float)newVertices + (1.0f - normals[triangle].Dot(axis));
+
+                    if (score < bestScore)
+                    {
+                        best      = triangle;
+                        bestScore = score;
+                    }
+                }
+            }
+
+            // no neighbor may be added, close the meshlet
+            if (best == triangleCount)
+            {
+                closeMeshlet();
+                continue;
+            }
+        }
+        else
+        {
+            // start a new meshlet from the next triangle not emitted yet, in the mesh order
+            while (seed < triangleCount && emitted[seed])
+                ++seed;
+
+            if (seed == triangleCount)
+                break;
+
+            best = seed;
+        }
+
+        // add the triangle to the meshlet
+        for (std::size_t k = 0; k < 3; ++k)
+        {
+            const std::uint32_t vertex = mesh.m_pIndices[best * 3 + k];
+
+            if (localIndices[vertex] == unused)
+            {
+                localIndices[vertex] = meshlet.m_VertexCount++;
+                meshlets.m_Vertices.push_back(vertex);
+            }
+
+            meshlets.m_Triangles.push_back((std::uint8_t)localIndices[vertex]);
+        }
+
+        emitted[best] = true;
+        normalSum    += normals[best];
+        ++meshlet.m_TriangleCount;
+
+        if (meshlet.m_TriangleCount < maxTriangles)
+            continue;
+
+        // the meshlet is full
+        closeMeshlet();
+    }
+
+    // close the last meshlet
+    if (meshlet.m_TriangleCount)
+        closeMeshlet();
+
+    return meshlets;
+}
+//---------------------------------------------------------------------------
+void MeshletBuilder::ComputeBounds(const MeshCompiler::IMeshView&            mesh,
+                                   const IMeshlets&                          meshlets,
+                                         IMeshlet&                           meshlet,
+                                         std::vector<MeshCompiler::IVertex>& positions)
+{
+    positions.resize(meshlet.m_VertexCount);
+
+    for (std::size_t i = 0; i < meshlet.m_VertexCount; ++i)
+        positions[i] = mesh.m_pVertices[meshlets.m_Vertices[meshlet.m_VertexOffset + i]];
+
+    meshlet.m_Sphere = MeshCompiler::ComputeSphere(positions.data(), positions.size());
+
+    const std::uint8_t* pTriangles = &meshlets.m_Triangles[meshlet.m_TriangleOffset];
+
+    // the cone axis is the average triangle normal
+    Math::Vector3F normalSum;
+
+    for (std::size_t i = 0; i < meshlet.m_TriangleCount; ++i)
+        normalSum += GetNormal(positions[pTriangles[i * 3]].m_Position,
+                               positions[pTriangles[i * 3 + 1]].m_Position,
+                               positions[pTriangles[i * 3 + 2]].m_Position);
+
+    meshlet.m_ConeAxis   = normalSum.Normalize();
+    meshlet.m_ConeApex   = meshlet.m_Sphere.m_Center;
+    meshlet.m_ConeCutoff = 1.0f;
+
+    // the cone half angle is the largest angle between the axis and a normal
+    float minDot = 1.0f;
+
+    for (std::size_t i = 0; i < meshlet.m_TriangleCount; ++i)
+    {
+        const Math::Vector3F normal = GetNormal(positions[pTriangles[i * 3]].m_Position,
+                                                positions[pTriangles[i * 3 + 1]].m_Position,
+                                                positions[pTriangles[i * 3 + 2]].m_Position);
+
+        // the degenerated triangles are never drawn
+        if (normal.Length() == 0.0f)
+            continue;
+
+        minDot = std::min(minDot, normal.Dot(meshlet.m_ConeAxis));
+    }
+
+    // too wide cone, the meshlet can't be facing away as a whole from most of the positions
+    if (minDot <= 0.1f)
+        return;
+
+    // move the apex back along the axis, until it's behind all the triangle planes
+    float maxDistance = 0.0f;
+
+    for (std::size_t i = 0; i < meshlet.m_TriangleCount; ++i)
+    {
+        const Math::Vector3F& position = positions[pTriangles[i * 3]].m_Position;
+        const Math::Vector3F  normal   = GetNormal(position,
+                                                   positions[pTriangles[i * 3 + 1]].m_Position,
+                                                   positions[pTriangles[i * 3 + 2]].m_Position);
+        const float           dot      = normal.Dot(meshlet.m_ConeAxis);
+
+        if (dot <= 0.0f)
+            continue;
+
+        maxDistance = std::max(maxDistance, (meshlet.m_Sphere.m_Center - position).Dot(normal) / dot);
+    }
+
+    meshlet.m_ConeApex   = meshlet.m_Sphere.m_Center - meshlet.m_ConeAxis * maxDistance;
+    meshlet.m_ConeCutoff = std::sqrt(1.0f - minDot * minDot);
+}
+//---------------------------------------------------------------------------
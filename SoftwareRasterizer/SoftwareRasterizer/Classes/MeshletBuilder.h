@@ -0,0 +1,153 @@
+/****************************************************************************
+ * ==> MeshletBuilder ------------------------------------------------------*
+ ****************************************************************************
+ * Description: Splits the compiled meshes in small clusters of triangles   *
+ * Developer:   Jean-Milost Reymond                                         *
+ ****************************************************************************
+ * MIT License                                                              *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files (the            *
+ * "Software"), to deal in the Software without restriction, including      *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sub-license, and/or sell copies of the Software, and to      *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+#pragma once
+
+// std
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// classes
+#include "Vector3.h"
+#include "MeshCompiler.h"
+
+namespace Model
+{
+    /**
+    * Meshlet builder, splits a compiled mesh in meshlets, which are small clusters of neighbor triangles.
+    * Each meshlet has a bounding sphere and a normal cone, so a whole meshlet outside the view frustum or
+    * facing away from the camera may be rejected with a single test, before its vertices are transformed
+    *@author Jean-Milost Reymond
+    */
+    class MeshletBuilder
+    {
+        public:
+            static const std::size_t m_DefaultMaxVertices  = 64;
+            static const std::size_t m_DefaultMaxTriangles = 64;
+
+            /**
+            * Meshlet
+            */
+            struct IMeshlet
+            {
+                std::uint32_t         m_VertexOffset   = 0;    // first vertex in IMeshlets::m_Vertices
+                std::uint32_t         m_VertexCount    = 0;
+                std::uint32_t         m_TriangleOffset = 0;    // first triangle index in IMeshlets::m_Triangles
+                std::uint32_t         m_TriangleCount  = 0;
+                MeshCompiler::ISphere m_Sphere;
+                Math::Vector3F        m_ConeApex;
+                Math::Vector3F        m_ConeAxis;
+                float                 m_ConeCutoff     = 1.0f; // sine of the cone half angle, 1 if never facing away
+            };
+
+            /**
+            * Meshlets of a mesh
+            */
+            struct IMeshlets
+            {
+                std::vector<IMeshlet>      m_Meshlets;
+                std::vector<std::uint32_t> m_Vertices;  // mesh vertex indices used by each meshlet, one meshlet after the other
+                std::vector<std::uint8_t>  m_Triangles; // each group of 3 items is a triangle, indexing its meshlet vertices
+            };
+
+            /**
+            * Splits a mesh in meshlets
+            *@param mesh - mesh to split
+            *@param maxVertices - maximum vertex count per meshlet, up to 256
+            *@param maxTriangles - maximum triangle count per meshlet
+            *@return the meshlets, which contain all the mesh triangles
+            *@note The meshlets are grown from triangle to neighbor triangle, preferring the ones which add no new
+            *      vertex, then the ones whose normal is the closest to the meshlet normals. The triangle order is
+            *      the one of the mesh as much as possible, so the mesh should be optimized before. The mesh should
+            *      be kept unchanged while the meshlets are used
+            */
+            static IMeshlets Build(const MeshCompiler::IMeshView& mesh,
+                                         std::size_t              maxVertices  = m_DefaultMaxVertices,
+                                         std::size_t              maxTriangles = m_DefaultMaxTriangles);
+
+            /**
+            * Checks if all the triangles of a meshlet are facing away from an eye
+            *@param meshlet - meshlet to check
+            *@param eye - eye position, in the mesh space
+            *@return true if all the meshlet triangles are facing away, otherwise false
+            *@note The triangles are front facing if they are clockwise on screen, as for the software renderer
+            *      default culling
+            */
+            static inline bool IsBackFacing(const IMeshlet& meshlet, const Math::Vector3F& eye);
+
+        private:
+            /**
+            * Calculates the meshlet bounding sphere and normal cone
+            *@param mesh - mesh
+            *@param meshlets - meshlets containing the meshlet
+            *@param[in, out] meshlet - meshlet whose bounds should be calculated
+            *@param[in, out] positions - buffer to reuse, for the meshlet vertices
+            */
+            static void ComputeBounds(const MeshCompiler::IMeshView&            mesh,
+                                      const IMeshlets&                          meshlets,
+                                            IMeshlet&                           meshlet,
+                                            std::vector<MeshCompiler::IVertex>& positions);
+
+            /**
+            * Calculates a triangle front normal
+            *@param v1 - first vertex position
+            *@param v2 - second vertex position
+            *@param v3 - third vertex position
+            *@return the normalized front normal, zero if the triangle is degenerated
+            */
+            static inline Math::Vector3F GetNormal(const Math::Vector3F& v1,
+                                                   const Math::Vector3F& v2,
+                                                   const Math::Vector3F& v3);
+    };
+
+    //---------------------------------------------------------------------------
+    // MeshletBuilder
+    //---------------------------------------------------------------------------
+    inline bool MeshletBuilder::IsBackFacing(const IMeshlet& meshlet, const Math::Vector3F& eye)
+    {
+        // the cone is too wide, and rounding could make the test below pass with the eye on the axis
+        if (meshlet.m_ConeCutoff >= 1.0f)
+            return false;
+
+        const Math::Vector3F direction = meshlet.m_ConeApex - eye;
+        const float          length    = direction.Length();
+
+        // the eye is behind all the triangles if it's inside the cone opposed to the normal cone, whose apex is
+        // behind all the triangle planes
+        return length > 0.0f && direction.Dot(meshlet.m_ConeAxis) >= meshlet.m_ConeCutoff * length;
+    }
+    //---------------------------------------------------------------------------
+    inline Math::Vector3F MeshletBuilder::GetNormal(const Math::Vector3F& v1,
+                                                    const Math::Vector3F& v2,
+                                                    const Math::Vector3F& v3)
+    {
+        return (v2 - v1).Cross(v3 - v1).Normalize();
+    }
+    //---------------------------------------------------------------------------
+}
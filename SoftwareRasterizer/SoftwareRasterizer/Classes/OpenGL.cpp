@@ -183,8 +183,11 @@ void Renderer::LoadTexture(unsigned char* data, int width, int height)
     m_HasTexture = true;
 }
 //---------------------------------------------------------------------------
-void Renderer::Render(const Model::WaveFront::IMesh& mesh) const
+void Renderer::Render(const Model::MeshCompiler::IMeshView& mesh) const
 {
+    if (!mesh.m_IndexCount)
+        return;
+
     // enable required features
     glEnable(GL_DEPTH_TEST);
 
@@ -194,48 +197,13 @@ void Renderer::Render(const Model::WaveFront::IMesh& mesh) const
         glBindTexture(GL_TEXTURE_2D, m_TextureID);
     }
 
-    // render each face
-    for (const auto& face : mesh.m_Faces)
-    {
-        // determine primitive type based on vertex count
-        GLenum mode;
-
-        if (face.m_VertexIndices.size() == 3)
-            mode = GL_TRIANGLES;
-        else
-        if (face.m_VertexIndices.size() == 4)
-            mode = GL_QUADS;
-        else
-            mode = GL_POLYGON;
-
-        glBegin(mode);
-
-        for (std::size_t i = 0; i < face.m_VertexIndices.size(); ++i)
-        {
-            // set texture coordinate if available
-            if (!face.m_TexCoordIndices.empty() && face.m_TexCoordIndices[i] < mesh.m_TexCoords.size())
-            {
-                const auto& tc = mesh.m_TexCoords[face.m_TexCoordIndices[i]];
-                glTexCoord2f(tc.m_X, tc.m_Y);
-            }
-
-            // set normal if available
-            if (!face.m_NormalIndices.empty() && face.m_NormalIndices[i] < mesh.m_Normals.size())
-            {
-                const auto& n = mesh.m_Normals[face.m_NormalIndices[i]];
-                glNormal3f(n.m_X, n.m_Y, n.m_Z);
-            }
-
-            // set vertex position
-            if (face.m_VertexIndices[i] < mesh.m_Vertices.size())
-            {
-                const auto& v = mesh.m_Vertices[face.m_VertexIndices[i]];
-                glVertex3f(v.m_X, v.m_Y, v.m_Z);
-            }
-        }
-
-        glEnd();
-    }
+    // the compiled vertices already match the interleaved format, so the whole mesh is drawn in one call
+    glInterleavedArrays(GL_T2F_N3F_V3F, 0, mesh.m_pVertices);
+    glDrawElements(GL_TRIANGLES, (GLsizei)mesh.m_IndexCount, GL_UNSIGNED_INT, mesh.m_pIndices);
+
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
 
     if (m_HasTexture)
         glDisable(GL_TEXTURE_2D);
@@ -29,7 +29,7 @@
 #pragma once
 
 // classes
-#include "WaveFront.h"
+#include "MeshCompiler.h"
 
 // windows
 #define WIN32_LEAN_AND_MEAN
@@ -118,9 +118,9 @@ namespace OpenGL
 
             /**
             * Renders the mesh
-            * @param mesh The mesh to render
+            * @param mesh The compiled mesh to render
             */
-            void Render(const Model::WaveFront::IMesh& mesh) const;
+            void Render(const Model::MeshCompiler::IMeshView& mesh) const;
 
         private:
             GLuint m_TextureID;
@@ -28,6 +28,9 @@
 
 #pragma once
 
+// std
+#include <type_traits>
+
 // classes
 #include "Vector3.h"
 
@@ -64,44 +67,39 @@ namespace Geometry
             * Copy constructor
             *@param other - other matrix to copy
             */
-            inline Plane(const Plane& other);
-
-            /**
-            * Destructor
-            */
-            inline ~Plane();
+            Plane(const Plane& other) = default;
 
             /**
             * Assignation operator
             *@param other - other matrix to copy from
             */
-            virtual inline Plane& operator = (const Plane& other);
+            Plane& operator = (const Plane& other) = default;
 
             /**
             * Operator -
             *@return inverted plane
             */
-            virtual inline Plane operator - () const;
+            inline Plane operator - () const;
 
             /**
             * Operator ==
             *@param other - other plane to compare
             *@return true if planes are identical, otherwise false
             */
-            virtual inline bool operator == (const Plane& other) const;
+            inline bool operator == (const Plane& other) const;
 
             /**
             * Operator !=
             *@param other - other plane to compare
             *@return true if planes are not identical, otherwise false
             */
-            virtual inline bool operator != (const Plane& other) const;
+            inline bool operator != (const Plane& other) const;
 
             /**
             * Copies plane from another
             *@param other - other matrix to copy from
             */
-            virtual inline void Copy(const Plane& other);
+            inline void Copy(const Plane& other);
 
             /**
             * Calculates a plane using 3 vertex
@@ -128,7 +126,7 @@ namespace Geometry
             *@param point - point from which the distance must be calculated
             *@return distance to plane
             */
-            virtual inline T DistanceTo(const Math::Vector3<T>& point) const;
+            inline T DistanceTo(const Math::Vector3<T>& point) const;
 
             /**
             * Compares 2 planes in the tolerance limit
@@ -136,12 +134,19 @@ namespace Geometry
             *@param tolerance - tolerance for comparison
             *@return true if planes are equal in the tolerance limit, otherwise false
             */
-            virtual inline bool Compare(const Plane& other, T tolerance) const;
+            inline bool Compare(const Plane& other, T tolerance) const;
     };
 
     typedef Plane<float>  PlaneF;
     typedef Plane<double> PlaneD;
 
+    static_assert(sizeof(PlaneF) == 4 * sizeof(float),  "PlaneF should only contain its values");
+    static_assert(sizeof(PlaneD) == 4 * sizeof(double), "PlaneD should only contain its values");
+    static_assert(std::is_trivially_copyable<PlaneF>::value && std::is_standard_layout<PlaneF>::value,
+                  "PlaneF should be trivially copyable and have a standard layout");
+    static_assert(std::is_trivially_copyable<PlaneD>::value && std::is_standard_layout<PlaneD>::value,
+                  "PlaneD should be trivially copyable and have a standard layout");
+
     //---------------------------------------------------------------------------
     // Plane
     //---------------------------------------------------------------------------
@@ -162,23 +167,6 @@ namespace Geometry
     {}
     //---------------------------------------------------------------------------
     template <class T>
-    Plane<T>::Plane(const Plane& other)
-    {
-        Copy(other);
-    }
-    //---------------------------------------------------------------------------
-    template <class T>
-    Plane<T>::~Plane()
-    {}
-    //---------------------------------------------------------------------------
-    template <class T>
-    Plane<T>& Plane<T>::operator = (const Plane& other)
-    {
-        Copy(other);
-        return *this;
-    }
-    //---------------------------------------------------------------------------
-    template <class T>
     Plane<T> Plane<T>::operator - () const
     {
         return Plane<T>(-m_A, -m_B, -m_C, -m_D);
@@ -0,0 +1,355 @@
+/****************************************************************************
+ * ==> Scene ---------------------------------------------------------------*
+ ****************************************************************************
+ * Description: Scene of mesh instances, organized in a bounding volume hierarchy*
+ * Developer:   Jean-Milost Reymond                                         *
+ ****************************************************************************
+ * MIT License                                                              *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files (the            *
+ * "Software"), to deal in the Software without restriction, including      *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sub-license, and/or sell copies of the Software, and to      *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+#include "Scene.h"
+
+// std
+#include <algorithm>
+#include <cmath>
+
+using namespace Model;
+
+//---------------------------------------------------------------------------
+// Global functions
+//---------------------------------------------------------------------------
+static inline float GetCenter(const MeshCompiler::IBox& box, std::size_t axis)
+{
+    // doubled, only used for comparisons
+    switch (axis)
+    {
+        case 0:  return box.m_Min.m_X + box.m_Max.m_X;
+        case 1:  return box.m_Min.m_Y + box.m_Max.m_Y;
+        default: return box.m_Min.m_Z + box.m_Max.m_Z;
+    }
+}
+//---------------------------------------------------------------------------
+static inline bool IsEqual(const MeshCompiler::IBox& box1, const MeshCompiler::IBox& box2)
+{
+    return box1.m_Min.m_X == box2.m_Min.m_X && box1.m_Min.m_Y == box2.m_Min.m_Y && box1.m_Min.m_Z == box2.m_Min.m_Z &&
+           box1.m_Max.m_X == box2.m_Max.m_X && box1.m_Max.m_Y == box2.m_Max.m_Y && box1.m_Max.m_Z == box2.m_Max.m_Z;
+}
+//---------------------------------------------------------------------------
+static inline bool IsOutside(const MeshCompiler::IBox& box, const Geometry::PlaneF* pPlanes, std::uint32_t& planeMask)
+{
+    for (std::size_t i = 0; i < 6; ++i)
+    {
+        if (!(planeMask & (1u << i)))
+            continue;
+
+        const Geometry::PlaneF& plane = pPlanes[i];
+
+        // the box corner the farthest along the plane normal, and the opposite one
+        const Math::Vector3F positive(plane.m_A >= 0.0f ? box.m_Max.m_X : box.m_Min.m_X,
+                                      plane.m_B >= 0.0f ? box.m_Max.m_Y : box.m_Min.m_Y,
+                                      plane.m_C >= 0.0f ? box.m_Max.m_Z : box.m_Min.m_Z);
+        const Math::Vector3F negative(plane.m_A >= 0.0f ? box.m_Min.m_X : box.m_Max.m_X,
+                                      plane.m_B >= 0.0f ? box.m_Min.m_Y : box.m_Max.m_Y,
+                                      plane.m_C >= 0.0f ? box.m_Min.m_Z : box.m_Max.m_Z);
+
+        if (plane.DistanceTo(positive) < 0.0f)
+            return true;
+
+        // fully inside this plane, which is thus no longer tested
+        if (plane.DistanceTo(negative) >= 0.0f)
+            planeMask &= ~(1u << i);
+    }
+
+    return false;
+}
+//---------------------------------------------------------------------------
+// Scene
+//---------------------------------------------------------------------------
+Scene::Scene()
+{}
+//---------------------------------------------------------------------------
+Scene::~Scene()
+{}
+//---------------------------------------------------------------------------
+std::size_t Scene::Add(const MeshCompiler::IMeshView&   mesh,
+                       const Math::Matrix4x4F&          matrix,
+                       const MeshletBuilder::IMeshlets* pMeshlets,
+                       const MeshSimplifier::ILods*     pLods)
+{
+    IInstance instance;
+    instance.m_Mesh      = mesh;
+    instance.m_pMeshlets = pMeshlets;
+    instance.m_pLods     = pLods;
+    instance.m_Matrix    = matrix;
+    instance.m_Box       = Transform(mesh.m_Box, matrix);
+
+    m_Instances.push_back(instance);
+    m_IsMoved.push_back(false);
+    m_Rebuild = true;
+
+    return m_Instances.size() - 1;
+}
+//---------------------------------------------------------------------------
+void Scene::SetMatrix(std::size_t index, const Math::Matrix4x4F& matrix)
+{
+    IInstance& instance = m_Instances[index];
+    instance.m_Matrix   = matrix;
+    instance.m_Box      = Transform(instance.m_Mesh.m_Box, matrix);
+
+    if (m_Rebuild || m_IsMoved[index])
+        return;
+
+    m_IsMoved[index] = true;
+    m_Moved.push_back((std::uint32_t)index);
+}
+//---------------------------------------------------------------------------
+void Scene::Clear()
+{
+    m_Instances.clear();
+    m_Nodes.clear();
+    m_Items.clear();
+    m_Leaves.clear();
+    m_Moved.clear();
+    m_IsMoved.clear();
+    m_Rebuild = false;
+}
+//---------------------------------------------------------------------------
+void Scene::Update()
+{
+    if (m_Rebuild)
+    {
+        Rebuild();
+        return;
+    }
+
+    // refit the nodes from the moved instances leaves to the root
+    for (std::size_t i = 0; i < m_Moved.size(); ++i)
+    {
+        m_IsMoved[m_Moved[i]] = false;
+
+        for (std::uint32_t node = m_Leaves[m_Moved[i]]; node != m_None; node = m_Nodes[node].m_Parent)
+        {
+            const MeshCompiler::IBox box = GetNodeBox(node);
+
+            // unchanged node, its parents are already up to date
+            if (IsEqual(box, m_Nodes[node].m_Box))
+                break;
+
+            m_Nodes[node].m_Box = box;
+        }
+    }
+
+    m_Moved.clear();
+}
+//---------------------------------------------------------------------------
+void Scene::Rebuild()
+{
+    m_Items.resize(m_Instances.size());
+    m_Leaves.resize(m_Instances.size());
+
+    for (std::size_t i = 0; i < m_Items.size(); ++i)
+        m_Items[i] = (std::uint32_t)i;
+
+    for (std::size_t i = 0; i < m_Moved.size(); ++i)
+        m_IsMoved[m_Moved[i]] = false;
+
+    m_Moved.clear();
+    m_Nodes.clear();
+    m_Rebuild = false;
+
+    if (m_Instances.empty())
+        return;
+
+    // a binary tree has less than twice as many nodes as leaves. The nodes are split at their median, so
+    // above the max leaf size a leaf holds at least 2 instances, and there are less nodes than instances
+    m_Nodes.reserve(m_Instances.size());
+    m_Nodes.resize(1);
+
+    BuildNode(0, 0, m_Items.size());
+}
+//---------------------------------------------------------------------------
+void Scene::Cull(const Geometry::PlaneF* pPlanes, IVisibleInstances& visible) const
+{
+    visible.clear();
+
+    if (m_Nodes.empty())
+        return;
+
+    /**
+    * Node to visit, and the planes it may be outside, those its parent was fully inside being skipped
+    */
+    struct IEntry
+    {
+        std::uint32_t m_Node;
+        std::uint32_t m_PlaneMask;
+    };
+
+    // the tree is balanced, so its depth is at most 32, and the stack contains at most one node per level plus one
+    IEntry      stack[64];
+    std::size_t count = 0;
+
+    stack[count++] = { 0, 0x3F };
+
+    while (count)
+    {
+        const IEntry  entry     = stack[--count];
+        const INode&  node      = m_Nodes[entry.m_Node];
+        std::uint32_t planeMask = entry.m_PlaneMask;
+
+        if (IsOutside(node.m_Box, pPlanes, planeMask))
+            continue;
+
+        if (node.m_Count)
+        {
+            // test each leaf instance, against the planes the leaf crosses only
+            for (std::uint32_t i = node.m_First; i < node.m_First + node.m_Count; ++i)
+            {
+                std::uint32_t instanceMask = planeMask;
+
+                if (IsOutside(m_Instances[m_Items[i]].m_Box, pPlanes, instanceMask))
+                    continue;
+
+                IVisibleInstance instance;
+                instance.m_Index  = m_Items[i];
+                instance.m_Inside = !instanceMask;
+                visible.push_back(instance);
+            }
+
+            continue;
+        }
+
+        stack[count++] = { node.m_First + 1, planeMask };
+        stack[count++] = { node.m_First,     planeMask };
+    }
+}
+//---------------------------------------------------------------------------
+void Scene::BuildNode(std::uint32_t node, std::size_t start, std::size_t end)
+{
+    if (end - start <= m_MaxLeafSize)
+    {
+        m_Nodes[node].m_First = (std::uint32_t)start;
+        m_Nodes[node].m_Count = (std::uint32_t)(end - start);
+        m_Nodes[node].m_Box   = GetNodeBox(node);
+
+        for (std::size_t i = start; i < end; ++i)
+            m_Leaves[m_Items[i]] = node;
+
+        return;
+    }
+
+    // bounds of the instance box centers
+    MeshCompiler::IBox centers;
+    centers.m_Min = centers.m_Max = (m_Instances[m_Items[start]].m_Box.m_Min + m_Instances[m_Items[start]].m_Box.m_Max);
+
+    for (std::size_t i = start + 1; i < end; ++i)
+    {
+        const MeshCompiler::IBox& box    = m_Instances[m_Items[i]].m_Box;
+        const Math::Vector3F      center = box.m_Min + box.m_Max;
+
+        centers.m_Min.m_X = std::min(centers.m_Min.m_X, center.m_X);
+        centers.m_Min.m_Y = std::min(centers.m_Min.m_Y, center.m_Y);
+        centers.m_Min.m_Z = std::min(centers.m_Min.m_Z, center.m_Z);
+        centers.m_Max.m_X = std::max(centers.m_Max.m_X, center.m_X);
+        centers.m_Max.m_Y = std::max(centers.m_Max.m_Y, center.m_Y);
+        centers.m_Max.m_Z = std::max(centers.m_Max.m_Z, center.m_Z);
+    }
+
+    // split the instances in 2 halves at the median center, along the axis on which the centers are the most spread
+    const Math::Vector3F spread = centers.m_Max - centers.m_Min;
+    const std::size_t    axis   = (spread.m_X >= spread.m_Y && spread.m_X >= spread.m_Z) ? 0 : (spread.m_Y >= spread.m_Z ? 1 : 2);
+    const std::size_t    middle = start + (end - start) / 2;
+
+    std::nth_element(m_Items.begin() + start,
+                     m_Items.begin() + middle,
+                     m_Items.begin() + end,
+                     [this, axis](std::uint32_t item1, std::uint32_t item2)
+                     {
+                         return GetCenter(m_Instances[item1].m_Box, axis) < GetCenter(m_Instances[item2].m_Box, axis);
+                     });
+
+    // the children are stored side by side
+    const std::uint32_t first = (std::uint32_t)m_Nodes.size();
+    m_Nodes.resize(first + 2);
+
+    m_Nodes[node].m_First       = first;
+    m_Nodes[node].m_Count       = 0;
+    m_Nodes[first].m_Parent     = node;
+    m_Nodes[first + 1].m_Parent = node;
+
+    BuildNode(first,     start,  middle);
+    BuildNode(first + 1, middle, end);
+
+    m_Nodes[node].m_Box = GetNodeBox(node);
+}
+//---------------------------------------------------------------------------
+MeshCompiler::IBox Scene::GetNodeBox(std::uint32_t node) const
+{
+    const INode& item = m_Nodes[node];
+
+    if (!item.m_Count)
+        return Merge(m_Nodes[item.m_First].m_Box, m_Nodes[item.m_First + 1].m_Box);
+
+    MeshCompiler::IBox box = m_Instances[m_Items[item.m_First]].m_Box;
+
+    for (std::uint32_t i = item.m_First + 1; i < item.m_First + item.m_Count; ++i)
+        box = Merge(box, m_Instances[m_Items[i]].m_Box);
+
+    return box;
+}
+//---------------------------------------------------------------------------
+MeshCompiler::IBox Scene::Transform(const MeshCompiler::IBox& box, const Math::Matrix4x4F& matrix)
+{
+    const Math::Vector3F center = (box.m_Min + box.m_Max) * 0.5f;
+    const Math::Vector3F extent = (box.m_Max - box.m_Min) * 0.5f;
+
+    // the transformed box extent on each axis is the sum of the source extents projected on it (Arvo's method)
+    const Math::Vector3F newCenter = matrix.Transform(center);
+    const Math::Vector3F newExtent(std::fabs(matrix.m_Table[0][0]) * extent.m_X +
+                                   std::fabs(matrix.m_Table[1][0]) * extent.m_Y +
+                                   std::fabs(matrix.m_Table[2][0]) * extent.m_Z,
+                                   std::fabs(matrix.m_Table[0][1]) * extent.m_X +
+                                   std::fabs(matrix.m_Table[1][1]) * extent.m_Y +
+                                   std::fabs(matrix.m_Table[2][1]) * extent.m_Z,
+                                   std::fabs(matrix.m_Table[0][2]) * extent.m_X +
+                                   std::fabs(matrix.m_Table[1][2]) * extent.m_Y +
+                                   std::fabs(matrix.m_Table[2][2]) * extent.m_Z);
+
+    MeshCompiler::IBox result;
+    result.m_Min = newCenter - newExtent;
+    result.m_Max = newCenter + newExtent;
+
+    return result;
+}
+//---------------------------------------------------------------------------
+MeshCompiler::IBox Scene::Merge(const MeshCompiler::IBox& box1, const MeshCompiler::IBox& box2)
+{
+    MeshCompiler::IBox box;
+    box.m_Min.m_X = std::min(box1.m_Min.m_X, box2.m_Min.m_X);
+    box.m_Min.m_Y = std::min(box1.m_Min.m_Y, box2.m_Min.m_Y);
+    box.m_Min.m_Z = std::min(box1.m_Min.m_Z, box2.m_Min.m_Z);
+    box.m_Max.m_X = std::max(box1.m_Max.m_X, box2.m_Max.m_X);
+    box.m_Max.m_Y = std::max(box1.m_Max.m_Y, box2.m_Max.m_Y);
+    box.m_Max.m_Z = std::max(box1.m_Max.m_Z, box2.m_Max.m_Z);
+
+    return box;
+}
+//---------------------------------------------------------------------------
@@ -0,0 +1,210 @@
+/****************************************************************************
+ * ==> Scene ---------------------------------------------------------------*
+ ****************************************************************************
+ * Description: Scene of mesh instances, organized in a bounding volume hierarchy*
+ * Developer:   Jean-Milost Reymond                                         *
+ ****************************************************************************
+ * MIT License                                                              *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files (the            *
+ * "Software"), to deal in the Software without restriction, including      *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sub-license, and/or sell copies of the Software, and to      *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+#pragma once
+
+// std
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// classes
+#include "Matrix4x4.h"
+#include "Plane.h"
+#include "MeshCompiler.h"
+#include "MeshletBuilder.h"
+#include "MeshSimplifier.h"
+
+namespace Model
+{
+    /**
+    * Scene, contains mesh instances organized in a bounding volume hierarchy (BVH) of their world boxes, so
+    * the instances outside the view frustum are skipped whole subtrees at once
+    *@author Jean-Milost Reymond
+    */
+    class Scene
+    {
+        public:
+            static const std::size_t m_MaxLeafSize = 4; // instances per BVH leaf
+
+            /**
+            * Mesh instance
+            */
+            struct IInstance
+            {
+                MeshCompiler::IMeshView          m_Mesh;
+                const MeshletBuilder::IMeshlets* m_pMeshlets = nullptr; // mesh meshlets, if any
+                const MeshSimplifier::ILods*     m_pLods     = nullptr; // mesh levels of detail, if any
+                Math::Matrix4x4F                 m_Matrix;              // model matrix
+                MeshCompiler::IBox               m_Box;                 // mesh box in world space
+            };
+
+            /**
+            * Visible instance
+            */
+            struct IVisibleInstance
+            {
+                std::uint32_t m_Index  = 0;
+                bool          m_Inside = false; // if true, the instance world box is fully inside the frustum
+            };
+
+            typedef std::vector<IVisibleInstance> IVisibleInstances;
+
+            Scene();
+            virtual ~Scene();
+
+            /**
+            * Adds a mesh instance
+            *@param mesh - mesh to add, should remain unchanged while the scene is used
+            *@param matrix - instance model matrix
+            *@param pMeshlets - mesh meshlets, ignored if nullptr. Should remain unchanged while the scene is used
+            *@param pLods - mesh levels of detail, ignored if nullptr. Should remain unchanged while the scene is used
+            *@return the instance index
+            *@note The hierarchy is rebuilt on the next update
+            */
+            std::size_t Add(const MeshCompiler::IMeshView&   mesh,
+                            const Math::Matrix4x4F&          matrix,
+                            const MeshletBuilder::IMeshlets* pMeshlets = nullptr,
+                            const MeshSimplifier::ILods*     pLods     = nullptr);
+
+            /**
+            * Moves an instance
+            *@param index - instance index
+            *@param matrix - new instance model matrix
+            *@note The hierarchy is refit on the next update
+            */
+            void SetMatrix(std::size_t index, const Math::Matrix4x4F& matrix);
+
+            /**
+            * Gets an instance
+            *@param index - instance index
+            *@return the instance
+            */
+            inline const IInstance& GetInstance(std::size_t index) const;
+
+            /**
+            * Gets the instance count
+            *@return the instance count
+            */
+            inline std::size_t GetCount() const;
+
+            /**
+            * Removes all the instances
+            */
+            void Clear();
+
+            /**
+            * Updates the hierarchy, should be called after the instances were added or moved, before culling
+            *@note The hierarchy is rebuilt if instances were added, otherwise only the boxes containing the moved
+            *      instances are refit, which costs in proportion to the moved instances only. A refit hierarchy
+            *      remains valid, but may become less efficient after large moves, Rebuild() restores it
+            */
+            void Update();
+
+            /**
+            * Rebuilds the whole hierarchy
+            */
+            void Rebuild();
+
+            /**
+            * Gets the instances inside or crossing a frustum
+            *@param pPlanes - frustum planes (array of 6 items), in world space, their normals pointing inside
+            *@param[out] visible - visible instances, cleared first
+            *@note The subtrees outside a plane are skipped, and the planes a subtree is inside aren't tested for
+            *      its children, so the cost is in proportion to the visible instances rather than to all of them
+            */
+            void Cull(const Geometry::PlaneF* pPlanes, IVisibleInstances& visible) const;
+
+        private:
+            static const std::uint32_t m_None = 0xFFFFFFFF;
+
+            /**
+            * Hierarchy node
+            */
+            struct INode
+            {
+                MeshCompiler::IBox m_Box;
+                std::uint32_t      m_Parent = m_None;
+                std::uint32_t      m_First  = 0; // first child for inner nodes, the second one follows, or first item for leaves
+                std::uint32_t      m_Count  = 0; // item count for leaves, 0 for inner nodes
+            };
+
+            std::vector<IInstance>     m_Instances;
+            std::vector<INode>         m_Nodes;
+            std::vector<std::uint32_t> m_Items;     // instance indices, in leaf order
+            std::vector<std::uint32_t> m_Leaves;    // leaf of each instance
+            std::vector<std::uint32_t> m_Moved;     // instances moved since the last update
+            std::vector<bool>          m_IsMoved;
+            bool                       m_Rebuild = false;
+
+            /**
+            * Builds a hierarchy node, and its children
+            *@param node - node index, already allocated with its parent
+            *@param start - node first item
+            *@param end - item following the node last one
+            */
+            void BuildNode(std::uint32_t node, std::size_t start, std::size_t end);
+
+            /**
+            * Calculates a node box from its items or its children
+            *@param node - node index
+            *@return the node box
+            */
+            MeshCompiler::IBox GetNodeBox(std::uint32_t node) const;
+
+            /**
+            * Transforms a box
+            *@param box - box to transform
+            *@param matrix - matrix
+            *@return the box containing the transformed box
+            */
+            static MeshCompiler::IBox Transform(const MeshCompiler::IBox& box, const Math::Matrix4x4F& matrix);
+
+            /**
+            * Merges 2 boxes
+            *@param box1 - first box
+            *@param box2 - second box
+            *@return the box containing both boxes
+            */
+            static MeshCompiler::IBox Merge(const MeshCompiler::IBox& box1, const MeshCompiler::IBox& box2);
+    };
+
+    //---------------------------------------------------------------------------
+    // Scene
+    //---------------------------------------------------------------------------
+    inline const Scene::IInstance& Scene::GetInstance(std::size_t index) const
+    {
+        return m_Instances[index];
+    }
+    //---------------------------------------------------------------------------
+    inline std::size_t Scene::GetCount() const
+    {
+        return m_Instances.size();
+    }
+    //---------------------------------------------------------------------------
+}
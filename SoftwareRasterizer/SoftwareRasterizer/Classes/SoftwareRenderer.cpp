@@ -28,11 +28,62 @@
 
 #include "SoftwareRenderer.h"
 
+// std
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#if RASTERIZER_SIMD
+    // sse4.1
+    #include <smmintrin.h>
+#endif
+
 // classes
-#include "Triangle.h"
+#include "TriangleSetup.h"
+#include "CommandList.h"
+#include "AllocationCounter.h"
 
 using namespace Rasterizer;
 
+//---------------------------------------------------------------------------
+// Global functions
+//---------------------------------------------------------------------------
+static inline void GetPosition(const Model::MeshCompiler::IVertex& vertex, float& x, float& y, float& z)
+{
+    x = vertex.m_Position.m_X;
+    y = vertex.m_Position.m_Y;
+    z = vertex.m_Position.m_Z;
+}
+//---------------------------------------------------------------------------
+static inline void GetPosition(const Model::MeshQuantizer::IVertex& vertex, float& x, float& y, float& z)
+{
+    // still quantized, the render matrix contains the dequantization
+    x = (float)vertex.m_Position[0];
+    y = (float)vertex.m_Position[1];
+    z = (float)vertex.m_Position[2];
+}
+//---------------------------------------------------------------------------
+static inline void GetAttributes(const Model::MeshCompiler::IVertex& vertex, Math::Vector2F& st, Math::Vector3F& normal)
+{
+    st     = vertex.m_TexCoord;
+    normal = vertex.m_Normal;
+}
+//---------------------------------------------------------------------------
+static inline void GetAttributes(const Model::MeshQuantizer::IVertex& vertex, Math::Vector2F& st, Math::Vector3F& normal)
+{
+    st.m_X = Model::MeshQuantizer::HalfToFloat(vertex.m_TexCoord[0]);
+    st.m_Y = Model::MeshQuantizer::HalfToFloat(vertex.m_TexCoord[1]);
+    normal = Model::MeshQuantizer::DecodeNormal(vertex.m_Normal);
+}
+//---------------------------------------------------------------------------
+static inline bool IsOutside(const Geometry::PlaneF* pPlanes, const Model::MeshCompiler::ISphere& sphere)
+{
+    for (std::size_t i = 0; i < 6; ++i)
+        if (pPlanes[i].DistanceTo(sphere.m_Center) < -sphere.m_Radius)
+            return true;
+
+    return false;
+}
 //---------------------------------------------------------------------------
 // Renderer
 //---------------------------------------------------------------------------
@@ -45,14 +96,20 @@ Renderer::Renderer()
 //---------------------------------------------------------------------------
 Renderer::~Renderer()
 {
-    if (m_pTexture)
-        delete[] m_pTexture;
+    // stop the back end, once the submitted frame is drawn
+    if (m_BackEnd.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_BackEndMutex);
+            m_StopBackEnd = true;
+        }
 
-    if (m_pZBuffer)
-        delete[] m_pZBuffer;
+        m_BackEndCondition.notify_all();
+        m_BackEnd.join();
+    }
 
-    if (m_hCanvas)
-        ::DeleteObject(m_hCanvas);
+    for (IFrame& frame : m_Frames)
+        DeleteFrame(frame);
 
     if (m_hMemDC)
         ::DeleteDC(m_hMemDC);
@@ -83,22 +140,15 @@ bool Renderer::Initialize(HWND hWnd, HDC hDC)
     if (!m_hMemDC)
         return false;
 
-    BITMAPINFO bmi              =  {};
-    bmi.bmiHeader.biSize        =  sizeof(BITMAPINFOHEADER);
-    bmi.bmiHeader.biWidth       =  (int)m_Width;
-    bmi.bmiHeader.biHeight      = -(int)m_Height;
-    bmi.bmiHeader.biPlanes      =  1;
-    bmi.bmiHeader.biBitCount    =  32;
-    bmi.bmiHeader.biCompression =  BI_RGB;
-
-    // create the canvas
-    m_hCanvas = ::CreateDIBSection(m_hMemDC, &bmi, DIB_RGB_COLORS, (void**)&m_pPixels, nullptr, 0);
-
-    if (!m_hCanvas)
-        return false;
+    m_BlocksX = (m_Width  + m_BlockSize - 1) / m_BlockSize;
+    m_BlocksY = (m_Height + m_BlockSize - 1) / m_BlockSize;
+    m_TilesX  = (m_Width  + m_TileSize  - 1) / m_TileSize;
+    m_TilesY  = (m_Height + m_TileSize  - 1) / m_TileSize;
 
-    // create the z buffer
-    m_pZBuffer = new float[(std::size_t)m_Width * (std::size_t)m_Height];
+    // create the buffers of the 2 frames, the second one is only used in pipelined mode
+    for (IFrame& frame : m_Frames)
+        if (!CreateFrame(frame))
+            return false;
 
     m_Initialized = true;
 
@@ -110,6 +160,9 @@ bool Renderer::Initialize(HWND hWnd, HDC hDC)
 //---------------------------------------------------------------------------
 void Renderer::SetProjection()
 {
+    // the back end reads the near and far values
+    WaitFrame();
+
     const float aspect    = (float)m_Width / (float)m_Height;
     const float fov       = 45.0f;
     const float nearPlane = 0.1f;
@@ -141,89 +194,479 @@ void Renderer::SetModel(const Math::Matrix4x4F& model)
     m_Model = model;
 }
 //---------------------------------------------------------------------------
+void Renderer::SetRenderMode(IERenderMode mode)
+{
+    if (mode == m_RenderMode)
+        return;
+
+    WaitFrame();
+
+    // drop the frame being prepared, and forget the drawn ones
+    m_Triangles.clear();
+    m_Draws.clear();
+    m_Clear                = false;
+    m_PreparedFrame        = 0;
+    m_FrameAllocations     = 0;
+    m_LastFrameAllocations = 0;
+    m_SteadyFrames         = 0;
+
+    for (IFrame& frame : m_Frames)
+    {
+        frame.m_Drawn      = false;
+        frame.m_BinGrowths = 0;
+    }
+
+    m_RenderMode = mode;
+
+    // the other modes draw in the first frame, with the selected texture
+    BindTexture(m_Frames[0], m_Texture);
+    MakeCurrent();
+}
+//---------------------------------------------------------------------------
+Renderer::IERenderMode Renderer::GetRenderMode() const
+{
+    return m_RenderMode;
+}
+//---------------------------------------------------------------------------
+void Renderer::SetDepthPrepass(bool value)
+{
+    if (value == m_DepthPrepass)
+        return;
+
+    m_DepthPrepass = value;
+
+    // the buffers may need to grow again
+    m_SteadyFrames = 0;
+}
+//---------------------------------------------------------------------------
+bool Renderer::GetDepthPrepass() const
+{
+    return m_DepthPrepass;
+}
+//---------------------------------------------------------------------------
+void Renderer::SetLodThreshold(float pixels)
+{
+    m_LodThreshold = pixels;
+}
+//---------------------------------------------------------------------------
+float Renderer::GetLodThreshold() const
+{
+    return m_LodThreshold;
+}
+//---------------------------------------------------------------------------
+void Renderer::SetSteadyState(bool value)
+{
+    m_SteadyState  = value;
+    m_SteadyFrames = 0;
+}
+//---------------------------------------------------------------------------
+std::size_t Renderer::GetLastFrameAllocations() const
+{
+    return m_LastFrameAllocations;
+}
+//---------------------------------------------------------------------------
 void Renderer::MakeCurrent() const
 {
     if (!m_Initialized)
         return;
 
-    if (m_hCanvas)
-        ::SelectObject(m_hMemDC, m_hCanvas);
+    if (m_Frames[0].m_hCanvas)
+        ::SelectObject(m_hMemDC, m_Frames[0].m_hCanvas);
 }
 //---------------------------------------------------------------------------
-void Renderer::LoadTexture(unsigned char* data, std::size_t width, std::size_t height, std::size_t bpp)
+std::size_t Renderer::LoadTexture(unsigned char* data, std::size_t width, std::size_t height, std::size_t bpp)
 {
-    if (m_HasTexture)
-        delete[] m_pTexture;
+    // the back end reads the textures
+    WaitFrame();
+
+    ITexture texture;
+    texture.m_Width  = width;
+    texture.m_Height = height;
+    texture.m_BPP    = bpp;
+
+    // copy the whole content from source
+    texture.m_Data.assign(data, data + (width * height * bpp));
+
+    m_Textures.push_back(std::move(texture));
 
-    m_TexWidth  = (std::size_t)width;
-    m_TexHeight = (std::size_t)height;
-    m_TexBPP    = bpp;
+    const std::size_t index = m_Textures.size() - 1;
+
+    // the textures may have moved, selecting the new one binds it again. The pipelined frames bind their
+    // textures before being drawn
+    SetTexture(index);
+
+    return index;
+}
+//---------------------------------------------------------------------------
+void Renderer::SetTexture(std::size_t index)
+{
+    m_Texture = index;
 
-    // calculate the texture buffer size
-    const std::size_t texSize = m_TexWidth * m_TexHeight * m_TexBPP;
+    // in pipelined mode, the texture is recorded with the draws, and bound by the back end
+    if (m_RenderMode != IERenderMode::Pipelined)
+        BindTexture(m_Frames[0], index);
+}
+//---------------------------------------------------------------------------
+void Renderer::SetCulling(IECullingType type, IECullingFace face)
+{
+    m_CullingType = type;
+    m_CullingFace = face;
+}
+//---------------------------------------------------------------------------
+void Renderer::Clear(COLORREF color)
+{
+    if (!m_Initialized)
+        return;
 
-    // create the texture buffer and copy the whole content from source
-    m_pTexture = new unsigned char[texSize];
-    std::memcpy(m_pTexture, data, texSize);
+    // in pipelined mode, the back end clears the frame buffers before drawing
+    if (m_RenderMode == IERenderMode::Pipelined)
+    {
+        m_ClearColor = color;
+        m_Clear      = true;
+        return;
+    }
 
-    m_HasTexture = true;
+    ClearBuffers(m_Frames[0], color);
 }
 //---------------------------------------------------------------------------
-void Renderer::Clear(COLORREF color) const
+void Renderer::ClearBuffers(const IFrame& frame, COLORREF color) const
 {
     // clear the canvas
     const DWORD dwColor = ((color & 0xFF) << 16) | (color & 0xFF00) | ((color >> 16) & 0xFF);
-    std::fill(m_pPixels, m_pPixels + ((std::size_t)m_Width * (std::size_t)m_Height), dwColor);
+    std::fill(frame.m_pPixels, frame.m_pPixels + ((std::size_t)m_Width * (std::size_t)m_Height), dwColor);
 
     // clear the z buffer
-    std::fill(m_pZBuffer, m_pZBuffer + ((std::size_t)m_Width * (std::size_t)m_Height), m_Far);
+    std::fill(frame.m_pZBuffer, frame.m_pZBuffer + ((std::size_t)m_Width * (std::size_t)m_Height), m_Far);
+
+    // clear the hierarchical z buffer
+    std::fill(frame.m_pHiZBuffer, frame.m_pHiZBuffer + (m_BlocksX * m_BlocksY), m_Far);
+    std::fill(frame.m_pHiZStale,  frame.m_pHiZStale  + (m_BlocksX * m_BlocksY), false);
+}
+//---------------------------------------------------------------------------
+void Renderer::Render(const Model::MeshCompiler::IMeshView& mesh)
+{
+    if (!m_Initialized)
+        return;
+
+    // calculate the render matrix (projection * view * model)
+    const Math::Matrix4x4F matrix = m_Model.Multiply(m_View).Multiply(m_Projection);
+
+    // whole mesh frustum culling
+    const IEContainment containment = GetContainment(mesh.m_Box, mesh.m_Sphere, matrix);
+
+    if (containment == IEContainment::Outside)
+        return;
+
+    RenderMesh(mesh.m_pVertices,
+               mesh.m_VertexCount,
+               mesh.m_pIndices,
+               mesh.m_IndexCount,
+               matrix,
+               containment == IEContainment::Inside);
+}
+//---------------------------------------------------------------------------
+void Renderer::Render(const Model::MeshCompiler::IMeshView& mesh, const Model::MeshletBuilder::IMeshlets& meshlets)
+{
+    if (!m_Initialized)
+        return;
+
+    // calculate the render matrix (projection * view * model)
+    const Math::Matrix4x4F matrix = m_Model.Multiply(m_View).Multiply(m_Projection);
+
+    // whole mesh frustum culling
+    const IEContainment containment = GetContainment(mesh.m_Box, mesh.m_Sphere, matrix);
+
+    if (containment == IEContainment::Outside)
+        return;
+
+    RenderMeshlets(mesh, meshlets, matrix, containment == IEContainment::Inside);
 }
 //---------------------------------------------------------------------------
-void Renderer::Render(const Model::WaveFront::IMesh& mesh) const
+void Renderer::Render(const Model::MeshCompiler::IMeshView& mesh, const Model::MeshSimplifier::ILods& lods)
 {
+    if (!m_Initialized)
+        return;
+
     // calculate the render matrix (projection * view * model)
     const Math::Matrix4x4F matrix = m_Model.Multiply(m_View).Multiply(m_Projection);
 
-    // iterate through model faces to draw
-    for (const auto& face : mesh.m_Faces)
+    // whole mesh frustum culling, the levels of detail are inside the source mesh bounding volumes
+    const IEContainment containment = GetContainment(mesh.m_Box, mesh.m_Sphere, matrix);
+
+    if (containment == IEContainment::Outside)
+        return;
+
+    const std::size_t level = SelectLod(lods, mesh.m_Sphere, matrix);
+
+    // the levels of detail share the source mesh vertices
+    RenderMesh(mesh.m_pVertices,
+               mesh.m_VertexCount,
+               level ? lods[level].m_Indices.data() : mesh.m_pIndices,
+               level ? lods[level].m_Indices.size() : mesh.m_IndexCount,
+               matrix,
+               containment == IEContainment::Inside);
+}
+//---------------------------------------------------------------------------
+void Renderer::Render(const Model::Scene& scene)
+{
+    if (!m_Initialized)
+        return;
+
+    // the scene is culled in world space
+    const Math::Matrix4x4F viewProjection = m_View.Multiply(m_Projection);
+
+    Geometry::PlaneF planes[6];
+    GetFrustum(viewProjection, planes);
+
+    scene.Cull(planes, m_VisibleInstances);
+
+    for (std::size_t i = 0; i < m_VisibleInstances.size(); ++i)
     {
-        // for now only triangles are supported
-        if (face.m_VertexIndices.size() != 3)
+        const Model::Scene::IInstance& instance = scene.GetInstance(m_VisibleInstances[i].m_Index);
+
+        // calculate the render matrix (projection * view * model)
+        const Math::Matrix4x4F matrix = instance.m_Matrix.Multiply(viewProjection);
+
+        // the instance world box may cross the frustum while its mesh is inside or outside
+        const IEContainment containment = m_VisibleInstances[i].m_Inside ?
+                IEContainment::Inside : GetContainment(instance.m_Mesh.m_Box, instance.m_Mesh.m_Sphere, matrix);
+
+        if (containment == IEContainment::Outside)
             continue;
 
-        Geometry::Polygon           polygon;
-        std::vector<Math::Vector3F> normal;
-        std::vector<Math::Vector2F> st;
+        const std::size_t level = instance.m_pLods ? SelectLod(*instance.m_pLods, instance.m_Mesh.m_Sphere, matrix) : 0;
+
+        if (level)
+            RenderMesh(instance.m_Mesh.m_pVertices,
+                       instance.m_Mesh.m_VertexCount,
+                       (*instance.m_pLods)[level].m_Indices.data(),
+                       (*instance.m_pLods)[level].m_Indices.size(),
+                       matrix,
+                       containment == IEContainment::Inside);
+        else
+        if (instance.m_pMeshlets)
+            RenderMeshlets(instance.m_Mesh, *instance.m_pMeshlets, matrix, containment == IEContainment::Inside);
+        else
+            RenderMesh(instance.m_Mesh.m_pVertices,
+                       instance.m_Mesh.m_VertexCount,
+                       instance.m_Mesh.m_pIndices,
+                       instance.m_Mesh.m_IndexCount,
+                       matrix,
+                       containment == IEContainment::Inside);
+    }
+}
+//---------------------------------------------------------------------------
+void Renderer::RenderInstanced(const Model::MeshCompiler::IMeshView& mesh,
+                               const Math::Matrix4x4F*               pMatrices,
+                                     std::size_t                     count)
+{
+    if (!m_Initialized || !mesh.m_VertexCount)
+        return;
+
+    #if ALLOCATION_COUNTER
+        const std::size_t allocationCount = GetAllocationCount();
+    #endif
+
+    const Math::Matrix4x4F viewProjection = m_View.Multiply(m_Projection);
+
+    m_Instances.clear();
+    m_Instances.reserve(count);
+
+    // calculate the instance render matrices (projection * view * model) and cull the instances
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const Math::Matrix4x4F matrix      = pMatrices[i].Multiply(viewProjection);
+        const IEContainment    containment = GetContainment(mesh.m_Box, mesh.m_Sphere, matrix);
+
+        if (containment != IEContainment::Outside)
+            m_Instances.push_back({matrix, containment == IEContainment::Inside});
+    }
+
+    if (m_Instances.empty())
+    {
+        #if ALLOCATION_COUNTER
+            m_FrameAllocations += GetAllocationCount() - allocationCount;
+        #endif
+
+        return;
+    }
+
+    const std::size_t vertexCount   = mesh.m_VertexCount;
+    const std::size_t triangleCount = mesh.m_IndexCount / 3;
+    const std::size_t batchCount    = (vertexCount + m_VertexBatchSize - 1) / m_VertexBatchSize;
+    const std::size_t groupSize     = std::max(m_InstanceBatchSize / vertexCount, (std::size_t)1);
+
+    // the positions are the same for all the instances, convert them once
+    LoadPositions(mesh.m_pVertices, vertexCount);
+
+    // render the instances by groups, whose vertices are transformed together, and whose triangles are
+    // binned and rasterized together
+    for (std::size_t first = 0; first < m_Instances.size(); first += groupSize)
+    {
+        const std::size_t groupCount = std::min(groupSize, m_Instances.size() - first);
+
+        // vertex stage, each instance vertices are written after the previous instance ones
+        m_ScreenVertices.Resize(vertexCount * groupCount);
+
+        m_ThreadPool.Run(groupCount * batchCount,
+                         [this, first, vertexCount, batchCount](std::size_t job)
+                         {
+                             const std::size_t instance = job / batchCount;
+                             const std::size_t start    = (job % batchCount) * m_VertexBatchSize;
+
+                             ProjectVertexRange(m_Instances[first + instance].m_Matrix,
+                                                start,
+                                                instance * vertexCount + start,
+                                                std::min(m_VertexBatchSize, vertexCount - start));
+                         });
 
-        normal.resize(face.m_VertexIndices.size());
-        st.resize(face.m_VertexIndices.size());
+        BeginTriangles(groupCount * triangleCount);
 
-        // for each face, iterate through its vertices
-        for (std::size_t i = 0; i < face.m_VertexIndices.size(); ++i)
+        for (std::size_t i = 0; i < groupCount; ++i)
         {
-            // set texture coordinate if available
-            if (!face.m_TexCoordIndices.empty() && face.m_TexCoordIndices[i] < mesh.m_TexCoords.size())
-                st[i] = mesh.m_TexCoords[face.m_TexCoordIndices[i]];
+            const std::size_t offset = i * vertexCount;
+            const bool        inside = m_Instances[first + i].m_Inside;
 
-            // set normal if available
-            if (!face.m_NormalIndices.empty() && face.m_NormalIndices[i] < mesh.m_Normals.size())
-                normal[i] = mesh.m_Normals[face.m_NormalIndices[i]];
+            for (std::size_t j = 0; j + 2 < mesh.m_IndexCount; j += 3)
+            {
+                Geometry::Polygon polygon;
+                Math::Vector3F    normal[3];
+                Math::Vector2F    st[3];
+
+                for (std::size_t k = 0; k < 3; ++k)
+                {
+                    const std::uint32_t index = mesh.m_pIndices[j + k];
+
+                    GetAttributes(mesh.m_pVertices[index], st[k], normal[k]);
 
-            // set vertex position
-            if (face.m_VertexIndices[i] < mesh.m_Vertices.size())
-                polygon.m_Vertex[i] = mesh.m_Vertices[face.m_VertexIndices[i]];
+                    // set vertex screen position
+                    polygon.m_Vertex[k] = Math::Vector3F(m_ScreenVertices.m_X[offset + index],
+                                                         m_ScreenVertices.m_Y[offset + index],
+                                                         m_ScreenVertices.m_Z[offset + index]);
+                }
+
+                AddTriangle(polygon, normal, st, inside);
+            }
         }
 
-        DrawPolygon(polygon, normal, st, matrix);
+        DrawTriangles();
+    }
+
+    #if ALLOCATION_COUNTER
+        m_FrameAllocations += GetAllocationCount() - allocationCount;
+    #endif
+}
+//---------------------------------------------------------------------------
+void Renderer::Execute(const CommandList& commands)
+{
+    if (!m_Initialized)
+        return;
+
+    const CommandList::ICommands& commandList    = commands.GetCommands();
+    const Math::Matrix4x4F        viewProjection = m_View.Multiply(m_Projection);
+
+    m_SortedCommands.clear();
+    m_SortedCommands.reserve(commandList.size());
+
+    for (std::size_t i = 0; i < commandList.size(); ++i)
+    {
+        const CommandList::ICommand& command = commandList[i];
+
+        // the mesh depth is the clip z coordinate of its bounding sphere center. The bits of a positive float
+        // are ordered as its value, the meshes behind the camera are sorted first, they are culled anyway
+        const Math::Matrix4x4F matrix = command.m_Model.Multiply(viewProjection);
+        const float            depth  = std::max(matrix.Transform(command.m_Mesh.m_Sphere.m_Center).m_Z, 0.0f);
+
+        std::uint32_t depthBits;
+        std::memcpy(&depthBits, &depth, sizeof(depthBits));
+
+        const std::uint64_t textureKey = std::min(command.m_Texture, (std::size_t)0xFFFFFFFF);
+
+        m_SortedCommands.push_back({(textureKey << 32) | depthBits, (std::uint32_t)i});
+    }
+
+    // sort by texture, then front to back. The index keeps the recording order between equal keys
+    std::sort(m_SortedCommands.begin(), m_SortedCommands.end(), [](const ISortedCommand& a, const ISortedCommand& b)
+    {
+        return a.m_Key != b.m_Key ? a.m_Key < b.m_Key : a.m_Index < b.m_Index;
+    });
+
+    const Math::Matrix4x4F model       = m_Model;
+    const std::size_t      texture     = m_Texture;
+    const IECullingType    cullingType = m_CullingType;
+    const IECullingFace    cullingFace = m_CullingFace;
+
+    for (std::size_t i = 0; i < m_SortedCommands.size(); ++i)
+    {
+        const CommandList::ICommand& command = commandList[m_SortedCommands[i].m_Index];
+
+        // select the texture only when it changes
+        if (!i || command.m_Texture != m_Texture)
+            SetTexture(command.m_Texture);
+
+        m_Model       = command.m_Model;
+        m_CullingType = command.m_CullingType;
+        m_CullingFace = command.m_CullingFace;
+
+        Render(command.m_Mesh);
     }
+
+    m_Model       = model;
+    m_CullingType = cullingType;
+    m_CullingFace = cullingFace;
+
+    SetTexture(texture);
+}
+//---------------------------------------------------------------------------
+void Renderer::Render(const Model::MeshQuantizer::IMesh& mesh)
+{
+    if (!m_Initialized)
+        return;
+
+    // calculate the render matrix (projection * view * model)
+    const Math::Matrix4x4F matrix = m_Model.Multiply(m_View).Multiply(m_Projection);
+
+    // whole mesh frustum culling, the bounding volumes aren't quantized
+    const IEContainment containment = GetContainment(mesh.m_Box, mesh.m_Sphere, matrix);
+
+    if (containment == IEContainment::Outside)
+        return;
+
+    // the positions are dequantized before being rendered
+    RenderMesh(mesh.m_Vertices.data(),
+               mesh.m_Vertices.size(),
+               mesh.m_Indices.data(),
+               mesh.m_Indices.size(),
+               Model::MeshQuantizer::GetDequantizationMatrix(mesh).Multiply(matrix),
+               containment == IEContainment::Inside);
 }
 //---------------------------------------------------------------------------
-void Renderer::SwapBuffers() const
+void Renderer::SwapBuffers()
 {
     if (!m_Initialized)
         return;
 
-    ::BitBlt(m_hDC, 0, 0, (int)m_Width, (int)m_Height, m_hMemDC, 0, 0, SRCCOPY);
+    if (m_RenderMode == IERenderMode::Pipelined)
+        SubmitFrame();
+    else
+    {
+        ::BitBlt(m_hDC, 0, 0, (int)m_Width, (int)m_Height, m_hMemDC, 0, 0, SRCCOPY);
+
+        m_LastFrameAllocations   = m_FrameAllocations - m_Frames[0].m_BinGrowths;
+        m_FrameAllocations       = 0;
+        m_Frames[0].m_BinGrowths = 0;
+    }
+
+    #if ALLOCATION_COUNTER
+        // in steady state, the frames should never allocate once the buffers grew to fit them. In pipelined
+        // mode, both frames should grow their arrays, and the allocations are known one frame later
+        const std::size_t warmUpFrames = m_RenderMode == IERenderMode::Pipelined ? 3 : 1;
+
+        if (m_SteadyState && m_SteadyFrames < warmUpFrames)
+            ++m_SteadyFrames;
+        else
+            assert(!m_SteadyState || !m_LastFrameAllocations);
+    #endif
 }
 //---------------------------------------------------------------------------
 Math::Vector3F Renderer::TransformVertex(const Math::Vector3F&   vertex,
@@ -247,168 +690,1200 @@ Math::Vector3F Renderer::TransformVertex(const Math::Vector3F&   vertex,
     return screen;
 }
 //---------------------------------------------------------------------------
-bool Renderer::DrawPolygon(const Geometry::Polygon&           polygon,
-                           const std::vector<Math::Vector3F>& normal,
-                           const std::vector<Math::Vector2F>& st,
-                           const Math::Matrix4x4F&            matrix) const
+std::size_t Renderer::GetAllocationCount() const
 {
-    // transform vertices to screen space
-    Geometry::Polygon rasterPoly(TransformVertex(polygon.m_Vertex[0], matrix),
-                                 TransformVertex(polygon.m_Vertex[1], matrix),
-                                 TransformVertex(polygon.m_Vertex[2], matrix));
-
-    // check if the polygon is culled
-    switch (m_CullingType)
-    {
-        case IECullingType::None:
-            break;
-
-        case IECullingType::Front:
-        case IECullingType::Back:
-        {
-            // use 2D cross product for screen-space culling
-            const float edge1X = rasterPoly.m_Vertex[1].m_X - rasterPoly.m_Vertex[0].m_X;
-            const float edge1Y = rasterPoly.m_Vertex[1].m_Y - rasterPoly.m_Vertex[0].m_Y;
-            const float edge2X = rasterPoly.m_Vertex[2].m_X - rasterPoly.m_Vertex[0].m_X;
-            const float edge2Y = rasterPoly.m_Vertex[2].m_Y - rasterPoly.m_Vertex[0].m_Y;
-            const float crossZ = edge1X * edge2Y - edge1Y * edge2X;
-
-            switch (m_CullingFace)
-            {
-                case IECullingFace::CCW:
-                    if (crossZ <= 0.0f)
-                        return true;
+    // a single thread drives the frame in the immediate and binned modes, so all the allocations are its own
+    // or its workers ones. In pipelined mode, the front end and the back end run concurrently, each one counts
+    // its own allocations, to which the workers running its jobs add theirs
+    if (m_RenderMode == IERenderMode::Pipelined)
+        return Debug::AllocationCounter::GetThread();
 
-                    break;
+    return Debug::AllocationCounter::Get();
+}
+//---------------------------------------------------------------------------
+bool Renderer::CreateFrame(IFrame& frame)
+{
+    BITMAPINFO bmi              =  {};
+    bmi.bmiHeader.biSize        =  sizeof(BITMAPINFOHEADER);
+    bmi.bmiHeader.biWidth       =  (int)m_Width;
+    bmi.bmiHeader.biHeight      = -(int)m_Height;
+    bmi.bmiHeader.biPlanes      =  1;
+    bmi.bmiHeader.biBitCount    =  32;
+    bmi.bmiHeader.biCompression =  BI_RGB;
 
-                case IECullingFace::CW:
-                    if (crossZ >= 0.0f)
-                        return true;
+    // create the canvas
+    frame.m_hCanvas = ::CreateDIBSection(m_hMemDC, &bmi, DIB_RGB_COLORS, (void**)&frame.m_pPixels, nullptr, 0);
 
-                    break;
+    if (!frame.m_hCanvas)
+        return false;
 
-                default:
-                    return true;
-            }
+    // create the z buffer
+    frame.m_pZBuffer = new float[(std::size_t)m_Width * (std::size_t)m_Height];
 
-            break;
-        }
+    // create the hierarchical z buffer
+    frame.m_pHiZBuffer = new float[m_BlocksX * m_BlocksY];
+    frame.m_pHiZStale  = new bool[m_BlocksX * m_BlocksY];
 
-        case IECullingType::Both:
-        default:
-            return true;
-    }
+    // create the screen tile bins
+    frame.m_BinOffsets.resize(m_TilesX * m_TilesY + 1);
 
-    // invert original depth values for perspective-correct interpolation
-    rasterPoly.m_Vertex[0].m_Z = 1.0f / rasterPoly.m_Vertex[0].m_Z;
-    rasterPoly.m_Vertex[1].m_Z = 1.0f / rasterPoly.m_Vertex[1].m_Z;
-    rasterPoly.m_Vertex[2].m_Z = 1.0f / rasterPoly.m_Vertex[2].m_Z;
+    return true;
+}
+//---------------------------------------------------------------------------
+void Renderer::DeleteFrame(IFrame& frame)
+{
+    if (frame.m_pZBuffer)
+        delete[] frame.m_pZBuffer;
 
-    std::vector<Math::Vector2F> texCoord;
-    texCoord.resize(3);
+    if (frame.m_pHiZBuffer)
+        delete[] frame.m_pHiZBuffer;
 
-    // pre-calculate perspective-correct texture coordinates
-    texCoord[0].m_X = st[0].m_X * rasterPoly.m_Vertex[0].m_Z;
-    texCoord[0].m_Y = st[0].m_Y * rasterPoly.m_Vertex[0].m_Z;
-    texCoord[1].m_X = st[1].m_X * rasterPoly.m_Vertex[1].m_Z;
-    texCoord[1].m_Y = st[1].m_Y * rasterPoly.m_Vertex[1].m_Z;
-    texCoord[2].m_X = st[2].m_X * rasterPoly.m_Vertex[2].m_Z;
-    texCoord[2].m_Y = st[2].m_Y * rasterPoly.m_Vertex[2].m_Z;
+    if (frame.m_pHiZStale)
+        delete[] frame.m_pHiZStale;
 
-    Geometry::Triangle triangle;
+    if (frame.m_hCanvas)
+        ::DeleteObject(frame.m_hCanvas);
+}
+//---------------------------------------------------------------------------
+void Renderer::BindTexture(IFrame& frame, std::size_t index) const
+{
+    frame.m_pTexture = index < m_Textures.size() ? &m_Textures[index] : nullptr;
+}
+//---------------------------------------------------------------------------
+void Renderer::SubmitFrame()
+{
+    // wait for the previous frame, its buffers may be displayed and the back end reused
+    WaitFrame();
 
-    // setup triangle for rasterization
-    triangle.m_Vertex[0] = Math::Vector2F(rasterPoly.m_Vertex[0].m_X, rasterPoly.m_Vertex[0].m_Y);
-    triangle.m_Vertex[1] = Math::Vector2F(rasterPoly.m_Vertex[1].m_X, rasterPoly.m_Vertex[1].m_Y);
-    triangle.m_Vertex[2] = Math::Vector2F(rasterPoly.m_Vertex[2].m_X, rasterPoly.m_Vertex[2].m_Y);
+    IFrame&       frame    = m_Frames[m_PreparedFrame];
+    const IFrame& previous = m_Frames[m_PreparedFrame ^ 1];
 
-    // calculate bounding box
-    const Geometry::Rect bbox = triangle.GetBoundingRect();
+    // the frame submitted before is now complete, without its expected bins growth
+    if (previous.m_Drawn)
+        m_LastFrameAllocations = previous.m_Allocations - previous.m_BinGrowths;
 
-    // cull if completely outside screen
-    if (bbox.m_Max.m_X < 0.0f || bbox.m_Min.m_X >= (float)m_Width ||
-            bbox.m_Max.m_Y < 0.0f || bbox.m_Min.m_Y >= (float)m_Height)
-        return true;
+    // hand the prepared frame over to the back end. The swapped arrays keep their capacity, so the front end
+    // stops to allocate once both frames are large enough
+    std::swap(frame.m_Triangles, m_Triangles);
+    std::swap(frame.m_Draws,     m_Draws);
+    frame.m_ClearColor  = m_ClearColor;
+    frame.m_Clear       = m_Clear;
+    frame.m_Allocations = m_FrameAllocations;
+    frame.m_BinGrowths  = 0;
+
+    m_Triangles.clear();
+    m_Draws.clear();
+    m_Clear            = false;
+    m_FrameAllocations = 0;
+
+    if (!m_BackEnd.joinable())
+        m_BackEnd = std::thread(&Renderer::RunBackEnd, this);
+
+    {
+        std::lock_guard<std::mutex> lock(m_BackEndMutex);
+        m_pSubmittedFrame = &frame;
+    }
+
+    m_BackEndCondition.notify_all();
+
+    m_PreparedFrame ^= 1;
+
+    // display the previous frame while the submitted one is drawn. The back end never uses the device contexts
+    if (previous.m_Drawn)
+    {
+        ::SelectObject(m_hMemDC, previous.m_hCanvas);
+        ::BitBlt(m_hDC, 0, 0, (int)m_Width, (int)m_Height, m_hMemDC, 0, 0, SRCCOPY);
+    }
+}
+//---------------------------------------------------------------------------
+void Renderer::WaitFrame()
+{
+    std::unique_lock<std::mutex> lock(m_BackEndMutex);
+    m_BackEndCondition.wait(lock, [this] { return !m_pSubmittedFrame; });
+}
+//---------------------------------------------------------------------------
+void Renderer::RunBackEnd()
+{
+    std::unique_lock<std::mutex> lock(m_BackEndMutex);
+
+    while (true)
+    {
+        m_BackEndCondition.wait(lock, [this] { return m_pSubmittedFrame || m_StopBackEnd; });
+
+        if (!m_pSubmittedFrame)
+            return;
+
+        IFrame* pFrame = m_pSubmittedFrame;
+
+        lock.unlock();
+        DrawFrame(*pFrame);
+        lock.lock();
+
+        m_pSubmittedFrame = nullptr;
+        m_BackEndCondition.notify_all();
+    }
+}
+//---------------------------------------------------------------------------
+void Renderer::DrawFrame(IFrame& frame)
+{
+    #if ALLOCATION_COUNTER
+        const std::size_t allocationCount = GetAllocationCount();
+    #endif
+
+    if (frame.m_Clear)
+        ClearBuffers(frame, frame.m_ClearColor);
+
+    std::size_t start = 0;
+
+    for (std::size_t i = 0; i < frame.m_Draws.size(); ++i)
+    {
+        const IDraw& draw = frame.m_Draws[i];
+
+        BindTexture(frame, draw.m_Texture);
+        RasterizeTriangles(frame, frame.m_Triangles, start, draw.m_End, draw.m_DepthPrepass);
+
+        start = draw.m_End;
+    }
+
+    #if ALLOCATION_COUNTER
+        frame.m_Allocations += GetAllocationCount() - allocationCount;
+    #endif
+
+    frame.m_Drawn = true;
+}
+//---------------------------------------------------------------------------
+void Renderer::GetFrustum(const Math::Matrix4x4F& matrix, Geometry::PlaneF* pPlanes) const
+{
+    // the clip coordinates are the dot products of the source position (x, y, z, 1) with the matrix columns,
+    // and the screen position is the clip one divided by its z coordinate. So the screen left edge is where
+    // x / z = -1, thus the plane x + z = 0 in clip space, which is the sum of the x and z columns in source
+    // space (Gribb-Hartmann method). The near and far planes are the z = near and z = far ones
+    for (std::size_t i = 0; i < 6; ++i)
+    {
+        const float       sign   = (i & 1) ? -1.0f : 1.0f;
+        const std::size_t column = i >> 1;
+
+        Geometry::PlaneF& plane = pPlanes[i];
+
+        if (column < 2)
+        {
+            // left, right, bottom and top planes
+            plane.m_A = matrix.m_Table[0][2] + sign * matrix.m_Table[0][column];
+            plane.m_B = matrix.m_Table[1][2] + sign * matrix.m_Table[1][column];
+            plane.m_C = matrix.m_Table[2][2] + sign * matrix.m_Table[2][column];
+            plane.m_D = matrix.m_Table[3][2] + sign * matrix.m_Table[3][column];
+        }
+        else
+        {
+            // near and far planes
+            plane.m_A = sign * matrix.m_Table[0][2];
+            plane.m_B = sign * matrix.m_Table[1][2];
+            plane.m_C = sign * matrix.m_Table[2][2];
+            plane.m_D = sign * (matrix.m_Table[3][2] - ((i & 1) ? m_Far : m_Near));
+        }
+
+        // normalize the plane, so its distance to a point may be compared to a radius
+        const float length = Math::Vector3F(plane.m_A, plane.m_B, plane.m_C).Length();
+
+        if (!length)
+            continue;
+
+        plane.m_A /= length;
+        plane.m_B /= length;
+        plane.m_C /= length;
+        plane.m_D /= length;
+    }
+}
+//---------------------------------------------------------------------------
+Renderer::IEContainment Renderer::GetContainment(const Model::MeshCompiler::IBox&    box,
+                                                 const Model::MeshCompiler::ISphere& sphere,
+                                                 const Math::Matrix4x4F&             matrix) const
+{
+    Geometry::PlaneF planes[6];
+    GetFrustum(matrix, planes);
+
+    bool sphereInside = true;
+    bool boxInside    = true;
+
+    for (std::size_t i = 0; i < 6; ++i)
+    {
+        const Geometry::PlaneF& plane = planes[i];
+
+        // the sphere is the cheapest test
+        const float distance = plane.DistanceTo(sphere.m_Center);
+
+        if (distance < -sphere.m_Radius)
+            return IEContainment::Outside;
+
+        if (distance < sphere.m_Radius)
+            sphereInside = false;
+
+        // the box corner the farthest along the plane normal, and the opposite one
+        const Math::Vector3F positive(plane.m_A >= 0.0f ? box.m_Max.m_X : box.m_Min.m_X,
+                                      plane.m_B >= 0.0f ? box.m_Max.m_Y : box.m_Min.m_Y,
+                                      plane.m_C >= 0.0f ? box.m_Max.m_Z : box.m_Min.m_Z);
+        const Math::Vector3F negative(plane.m_A >= 0.0f ? box.m_Min.m_X : box.m_Max.m_X,
+                                      plane.m_B >= 0.0f ? box.m_Min.m_Y : box.m_Max.m_Y,
+                                      plane.m_C >= 0.0f ? box.m_Min.m_Z : box.m_Max.m_Z);
+
+        // the box may be tighter than the sphere
+        if (plane.DistanceTo(positive) < 0.0f)
+            return IEContainment::Outside;
+
+        if (plane.DistanceTo(negative) < 0.0f)
+            boxInside = false;
+    }
+
+    // both volumes contain the whole mesh, so it's inside if any of them is
+    return (sphereInside || boxInside) ? IEContainment::Inside : IEContainment::Intersecting;
+}
+//---------------------------------------------------------------------------
+template <class TVertex>
+void Renderer::RenderMesh(const TVertex*          pVertices,
+                                std::size_t       vertexCount,
+                          const std::uint32_t*    pIndices,
+                                std::size_t       indexCount,
+                          const Math::Matrix4x4F& matrix,
+                                bool              inside)
+{
+    #if ALLOCATION_COUNTER
+        const std::size_t allocationCount = GetAllocationCount();
+    #endif
+
+    // vertex stage, transform each vertex once, whatever the number of triangles sharing it
+    TransformVertices(pVertices, vertexCount, matrix);
+
+    BeginTriangles(indexCount / 3);
+
+    // iterate through model triangles to draw, the indices were already validated by the mesh compiler
+    for (std::size_t i = 0; i + 2 < indexCount; i += 3)
+    {
+        Geometry::Polygon polygon;
+        Math::Vector3F    normal[3];
+        Math::Vector2F    st[3];
+
+        for (std::size_t j = 0; j < 3; ++j)
+        {
+            const std::uint32_t index = pIndices[i + j];
+
+            GetAttributes(pVertices[index], st[j], normal[j]);
+
+            // set vertex screen position
+            polygon.m_Vertex[j] = Math::Vector3F(m_ScreenVertices.m_X[index],
+                                                 m_ScreenVertices.m_Y[index],
+                                                 m_ScreenVertices.m_Z[index]);
+        }
+
+        AddTriangle(polygon, normal, st, inside);
+    }
+
+    DrawTriangles();
+
+    #if ALLOCATION_COUNTER
+        m_FrameAllocations += GetAllocationCount() - allocationCount;
+    #endif
+}
+//---------------------------------------------------------------------------
+void Renderer::RenderMeshlets(const Model::MeshCompiler::IMeshView&    mesh,
+                              const Model::MeshletBuilder::IMeshlets& meshlets,
+                              const Math::Matrix4x4F&                 matrix,
+                                    bool                              inside)
+{
+    #if ALLOCATION_COUNTER
+        const std::size_t allocationCount = GetAllocationCount();
+    #endif
+
+    Geometry::PlaneF planes[6];
+    GetFrustum(matrix, planes);
+
+    // the meshlet normal cones are built for the clockwise front faces, and the front and back culling types
+    // both cull the faces of the culling winding
+    const bool           coneCulling = (m_CullingType == IECullingType::Front ||
+                                        m_CullingType == IECullingType::Back) && m_CullingFace == IECullingFace::CW;
+    const Math::Vector3F eye         = GetEye(matrix);
+
+    m_VisibleMeshlets.clear();
+    m_VisibleMeshlets.reserve(meshlets.m_Meshlets.size());
+
+    // cluster culling, before any vertex work. The meshlets can't be outside if the whole mesh is inside
+    for (std::size_t i = 0; i < meshlets.m_Meshlets.size(); ++i)
+    {
+        const Model::MeshletBuilder::IMeshlet& meshlet = meshlets.m_Meshlets[i];
+
+        if (!inside && IsOutside(planes, meshlet.m_Sphere))
+            continue;
 
-    // clamp to screen bounds
-    const std::size_t x0 = (std::size_t)std::max(0.0f,              std::floorf(bbox.m_Min.m_X));
-    const std::size_t x1 = (std::size_t)std::min((float)(m_Width),  std::floorf(bbox.m_Max.m_X));
-    const std::size_t y0 = (std::size_t)std::max(0.0f,              std::floorf(bbox.m_Min.m_Y));
-    const std::size_t y1 = (std::size_t)std::min((float)(m_Height), std::floorf(bbox.m_Max.m_Y));
+        if (coneCulling && Model::MeshletBuilder::IsBackFacing(meshlet, eye))
+            continue;
+
+        m_VisibleMeshlets.push_back((std::uint32_t)i);
+    }
+
+    m_ModelVertices.Resize(meshlets.m_Vertices.size());
+    m_ScreenVertices.Resize(meshlets.m_Vertices.size());
+
+    // vertex stage, only the visible meshlet vertices are transformed, and stored at their meshlet position
+    m_ThreadPool.Run(m_VisibleMeshlets.size(),
+                     [this, &mesh, &meshlets, &matrix](std::size_t i)
+                     {
+                         const Model::MeshletBuilder::IMeshlet& meshlet = meshlets.m_Meshlets[m_VisibleMeshlets[i]];
+
+                         TransformVertexRange(mesh.m_pVertices,
+                                              meshlets.m_Vertices.data(),
+                                              meshlet.m_VertexOffset,
+                                              meshlet.m_VertexOffset + meshlet.m_VertexCount,
+                                              matrix);
+                     });
+
+    BeginTriangles(mesh.m_IndexCount / 3);
+
+    for (std::size_t i = 0; i < m_VisibleMeshlets.size(); ++i)
+    {
+        const Model::MeshletBuilder::IMeshlet& meshlet    = meshlets.m_Meshlets[m_VisibleMeshlets[i]];
+        const std::uint32_t*                   pVertices  = &meshlets.m_Vertices[meshlet.m_VertexOffset];
+        const std::uint8_t*                    pTriangles = &meshlets.m_Triangles[meshlet.m_TriangleOffset];
+
+        for (std::size_t j = 0; j < meshlet.m_TriangleCount; ++j)
+        {
+            Geometry::Polygon polygon;
+            Math::Vector3F    normal[3];
+            Math::Vector2F    st[3];
+
+            for (std::size_t k = 0; k < 3; ++k)
+            {
+                const std::uint8_t vertex = pTriangles[j * 3 + k];
+                const std::size_t  index  = meshlet.m_VertexOffset + vertex;
+
+                GetAttributes(mesh.m_pVertices[pVertices[vertex]], st[k], normal[k]);
+
+                // set vertex screen position
+                polygon.m_Vertex[k] = Math::Vector3F(m_ScreenVertices.m_X[index],
+                                                     m_ScreenVertices.m_Y[index],
+                                                     m_ScreenVertices.m_Z[index]);
+            }
+
+            AddTriangle(polygon, normal, st, inside);
+        }
+    }
+
+    DrawTriangles();
+
+    #if ALLOCATION_COUNTER
+        m_FrameAllocations += GetAllocationCount() - allocationCount;
+    #endif
+}
+//---------------------------------------------------------------------------
+std::size_t Renderer::SelectLod(const Model::MeshSimplifier::ILods& lods,
+                                const Model::MeshCompiler::ISphere& sphere,
+                                const Math::Matrix4x4F&             matrix) const
+{
+    // a source space length moves the clip x and y coordinates by at most the length of the matrix x and y
+    // columns times it, and the screen position is the clip one divided by the clip z coordinate
+    const Math::Vector3F column0(matrix.m_Table[0][0], matrix.m_Table[1][0], matrix.m_Table[2][0]);
+    const Math::Vector3F column1(matrix.m_Table[0][1], matrix.m_Table[1][1], matrix.m_Table[2][1]);
+    const Math::Vector3F column2(matrix.m_Table[0][2], matrix.m_Table[1][2], matrix.m_Table[2][2]);
+
+    // the error is projected where the mesh is the nearest to the camera, so it's the largest
+    const float depth = matrix.Transform(sphere.m_Center).m_Z - sphere.m_Radius * column2.Length();
+
+    if (depth <= m_Near)
+        return 0;
+
+    const float pixelsPerUnit = std::max(column0.Length() * (float)m_Width, column1.Length() * (float)m_Height) *
+                                0.5f / depth;
+
+    // the levels are ordered from the finest to the coarsest
+    std::size_t level = 0;
+
+    for (std::size_t i = 1; i < lods.size() && lods[i].m_Error * pixelsPerUnit <= m_LodThreshold; ++i)
+        level = i;
+
+    return level;
+}
+//---------------------------------------------------------------------------
+Math::Vector3F Renderer::GetEye(const Math::Matrix4x4F& matrix) const
+{
+    // the eye is the point whose x, y and z clip coordinates are all 0, as the screen position is the clip one
+    // divided by z. Solve the 3 equations dot(eye, column) + translation = 0 with the Cramer's rule
+    const Math::Vector3F column0(matrix.m_Table[0][0], matrix.m_Table[1][0], matrix.m_Table[2][0]);
+    const Math::Vector3F column1(matrix.m_Table[0][1], matrix.m_Table[1][1], matrix.m_Table[2][1]);
+    const Math::Vector3F column2(matrix.m_Table[0][2], matrix.m_Table[1][2], matrix.m_Table[2][2]);
+    const Math::Vector3F cross12     = column1.Cross(column2);
+    const float          determinant = column0.Dot(cross12);
+
+    if (!determinant)
+        return Math::Vector3F();
+
+    return (cross12               * matrix.m_Table[3][0] +
+            column2.Cross(column0) * matrix.m_Table[3][1] +
+            column0.Cross(column1) * matrix.m_Table[3][2]) * (-1.0f / determinant);
+}
+//---------------------------------------------------------------------------
+void Renderer::BeginTriangles(std::size_t count)
+{
+    // in pipelined mode, the triangles of the whole frame are kept. The array grows geometrically, as the
+    // frame triangle count is unknown
+    if (m_RenderMode == IERenderMode::Pipelined)
+    {
+        if (m_Triangles.capacity() < m_Triangles.size() + count)
+            m_Triangles.reserve(std::max(m_Triangles.size() + count, m_Triangles.capacity() * 2));
+
+        return;
+    }
+
+    m_Triangles.clear();
+
+    // the triangle array grows only once, when a larger mesh is rendered
+    if (m_RenderMode == IERenderMode::Binned || m_DepthPrepass)
+        m_Triangles.reserve(count);
+}
+//---------------------------------------------------------------------------
+void Renderer::AddTriangle(const Geometry::Polygon& polygon,
+                           const Math::Vector3F*    normal,
+                           const Math::Vector2F*    st,
+                                 bool               inside)
+{
+    // the mesh crosses the frustum, skip the triangles fully nearer than the near plane or farther than the
+    // far one. None of their pixels would pass the depth test, or they would be wrongly projected if behind
+    // the camera
+    if (!inside)
+    {
+        const float minZ = std::min(polygon.m_Vertex[0].m_Z, std::min(polygon.m_Vertex[1].m_Z, polygon.m_Vertex[2].m_Z));
+        const float maxZ = std::max(polygon.m_Vertex[0].m_Z, std::max(polygon.m_Vertex[1].m_Z, polygon.m_Vertex[2].m_Z));
+
+        if (maxZ < m_Near || minZ > m_Far)
+            return;
+    }
+
+    if (m_RenderMode != IERenderMode::Immediate || m_DepthPrepass)
+    {
+        TriangleSetup setup;
+
+        // front end, keep the triangle for binning or for the passes if not culled
+        if (SetupPolygon(polygon, st, setup))
+            m_Triangles.push_back(setup);
+    }
+    else
+        DrawPolygon(polygon, normal, st);
+}
+//---------------------------------------------------------------------------
+void Renderer::DrawTriangles()
+{
+    // in immediate mode without depth pre-pass, the triangles are already drawn
+    if (m_RenderMode == IERenderMode::Immediate && !m_DepthPrepass)
+        return;
+
+    if (m_RenderMode == IERenderMode::Pipelined)
+    {
+        const std::uint32_t end = (std::uint32_t)m_Triangles.size();
+
+        if (m_Draws.empty())
+        {
+            if (end)
+                m_Draws.push_back({end, m_Texture, m_DepthPrepass});
+
+            return;
+        }
+
+        IDraw& last = m_Draws.back();
+
+        if (end == last.m_End)
+            return;
+
+        // the triangles are drawn in their submission order anyway, so successive draws sharing the same
+        // state are merged, and binned once by the back end
+        if (last.m_Texture == m_Texture && last.m_DepthPrepass == m_DepthPrepass)
+            last.m_End = end;
+        else
+            m_Draws.push_back({end, m_Texture, m_DepthPrepass});
+
+        return;
+    }
+
+    RasterizeTriangles(m_Frames[0], m_Triangles, 0, m_Triangles.size(), m_DepthPrepass);
+}
+//---------------------------------------------------------------------------
+void Renderer::RasterizeTriangles(      IFrame&     frame,
+                                  const ITriangles& triangles,
+                                        std::size_t start,
+                                        std::size_t end,
+                                        bool        depthPrepass)
+{
+    if (m_RenderMode != IERenderMode::Immediate)
+        BinTriangles(frame, triangles, start, end);
+
+    if (depthPrepass)
+    {
+        // fill the depth buffer first, then shade the pixels which remained visible
+        frame.m_Pass = IEPass::Depth;
+        RasterizePass(frame, triangles, start, end);
+
+        frame.m_Pass = IEPass::Shading;
+        RasterizePass(frame, triangles, start, end);
+
+        frame.m_Pass = IEPass::Full;
+    }
+    else
+        RasterizePass(frame, triangles, start, end);
+}
+//---------------------------------------------------------------------------
+template <class TVertex>
+void Renderer::TransformVertices(const TVertex*          pVertices,
+                                       std::size_t       count,
+                                 const Math::Matrix4x4F& matrix)
+{
+    m_ModelVertices.Resize(count);
+    m_ScreenVertices.Resize(count);
+
+    // the vertices are independent, split them in batches shared between the workers
+    m_ThreadPool.Run((count + m_VertexBatchSize - 1) / m_VertexBatchSize,
+                     [this, pVertices, &matrix, count](std::size_t batch)
+                     {
+                         const std::size_t start = batch * m_VertexBatchSize;
+
+                         TransformVertexRange(pVertices, nullptr, start, std::min(start + m_VertexBatchSize, count), matrix);
+                     });
+}
+//---------------------------------------------------------------------------
+template <class TVertex>
+void Renderer::LoadPositions(const TVertex* pVertices, std::size_t count)
+{
+    m_ModelVertices.Resize(count);
+
+    m_ThreadPool.Run((count + m_VertexBatchSize - 1) / m_VertexBatchSize,
+                     [this, pVertices, count](std::size_t batch)
+                     {
+                         const std::size_t start = batch * m_VertexBatchSize;
+                         const std::size_t end   = std::min(start + m_VertexBatchSize, count);
+
+                         for (std::size_t i = start; i < end; ++i)
+                             GetPosition(pVertices[i],
+                                         m_ModelVertices.m_X[i],
+                                         m_ModelVertices.m_Y[i],
+                                         m_ModelVertices.m_Z[i]);
+                     });
+}
+//---------------------------------------------------------------------------
+template <class TVertex>
+void Renderer::TransformVertexRange(const TVertex*          pVertices,
+                                    const std::uint32_t*    pIndices,
+                                          std::size_t       start,
+                                          std::size_t       end,
+                                    const Math::Matrix4x4F& matrix)
+{
+    float* pModelX = &m_ModelVertices.m_X[start];
+    float* pModelY = &m_ModelVertices.m_Y[start];
+    float* pModelZ = &m_ModelVertices.m_Z[start];
+
+    // convert the positions to structure of arrays
+    for (std::size_t i = start; i < end; ++i)
+        GetPosition(pIndices ? pVertices[pIndices[i]] : pVertices[i],
+                    pModelX[i - start],
+                    pModelY[i - start],
+                    pModelZ[i - start]);
+
+    ProjectVertexRange(matrix, start, start, end - start);
+}
+//---------------------------------------------------------------------------
+void Renderer::ProjectVertexRange(const Math::Matrix4x4F& matrix,
+                                        std::size_t       modelStart,
+                                        std::size_t       screenStart,
+                                        std::size_t       count)
+{
+    float* pScreenX = &m_ScreenVertices.m_X[screenStart];
+    float* pScreenY = &m_ScreenVertices.m_Y[screenStart];
+    float* pScreenZ = &m_ScreenVertices.m_Z[screenStart];
+
+    // transform to clip space
+    matrix.Transform(&m_ModelVertices.m_X[modelStart],
+                     &m_ModelVertices.m_Y[modelStart],
+                     &m_ModelVertices.m_Z[modelStart],
+                     count,
+                     pScreenX,
+                     pScreenY,
+                     pScreenZ,
+                     nullptr);
+
+    const float width  = (float)m_Width;
+    const float height = (float)m_Height;
+
+    // perspective divide and conversion to screen space, same operations as TransformVertex()
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        pScreenX[i] = (pScreenX[i] / pScreenZ[i] + 1.0f) * 0.5f * width;
+        pScreenY[i] = (1.0f - pScreenY[i] / pScreenZ[i]) * 0.5f * height;
+    }
+}
+//---------------------------------------------------------------------------
+bool Renderer::SetupPolygon(const Geometry::Polygon& polygon,
+                            const Math::Vector2F*    st,
+                                  TriangleSetup&     setup) const
+{
+    // check if the polygon is culled
+    switch (m_CullingType)
+    {
+        case IECullingType::None:
+            break;
 
-    // rasterize triangle
-    for (std::size_t y = y0; y <= y1; ++y)
-        for (std::size_t x = x0; x <= x1; ++x)
+        case IECullingType::Front:
+        case IECullingType::Back:
         {
-            const Math::Vector2F         pixelSample(x + 0.5f, y + 0.5f);
-            Geometry::Triangle::IWeights weights;
+            // use 2D cross product for screen-space culling
+            const float edge1X = polygon.m_Vertex[1].m_X - polygon.m_Vertex[0].m_X;
+            const float edge1Y = polygon.m_Vertex[1].m_Y - polygon.m_Vertex[0].m_Y;
+            const float edge2X = polygon.m_Vertex[2].m_X - polygon.m_Vertex[0].m_X;
+            const float edge2Y = polygon.m_Vertex[2].m_Y - polygon.m_Vertex[0].m_Y;
+            const float crossZ = edge1X * edge2Y - edge1Y * edge2X;
 
-            if (triangle.BarycentricInside(pixelSample, weights))
+            switch (m_CullingFace)
             {
-                // clamp weight values between 0 and 1
-                float w0 = std::max(std::min(weights.m_W0, 1.0f), 0.0f);
-                float w1 = std::max(std::min(weights.m_W1, 1.0f), 0.0f);
-                float w2 = std::max(std::min(weights.m_W2, 1.0f), 0.0f);
+                case IECullingFace::CCW:
+                    if (crossZ <= 0.0f)
+                        return false;
 
-                // interpolate 1/z
-                const float invZ = rasterPoly.m_Vertex[0].m_Z * w0 +
-                                   rasterPoly.m_Vertex[1].m_Z * w1 +
-                                   rasterPoly.m_Vertex[2].m_Z * w2;
+                    break;
 
-                // convert back to z for depth testing
-                const float z = 1.0f / invZ;
+                case IECullingFace::CW:
+                    if (crossZ >= 0.0f)
+                        return false;
+
+                    break;
+
+                default:
+                    return false;
+            }
+
+            break;
+        }
+
+        case IECullingType::Both:
+        default:
+            return false;
+    }
+
+    // calculate the edge equations and the interpolant gradients, skip the triangle if nothing to draw
+    return setup.Setup(polygon, st, m_Width, m_Height);
+}
+//---------------------------------------------------------------------------
+void Renderer::RasterizePass(const IFrame& frame, const ITriangles& triangles, std::size_t start, std::size_t end)
+{
+    if (m_RenderMode != IERenderMode::Immediate)
+    {
+        // back end, each worker owns whole tiles, so color and depth writes never contend
+        m_ThreadPool.Run(m_TilesX * m_TilesY,
+                         [this, &frame, &triangles](std::size_t tile) { RasterizeTile(frame, triangles, tile); });
+        return;
+    }
+
+    for (std::size_t i = start; i < end; ++i)
+        RasterizeTriangle(frame, triangles[i], 0, 0, m_Width - 1, m_Height - 1);
+}
+//---------------------------------------------------------------------------
+void Renderer::RasterizeTriangle(const IFrame&        frame,
+                                 const TriangleSetup& setup,
+                                 std::size_t          minX,
+                                 std::size_t          minY,
+                                 std::size_t          maxX,
+                                 std::size_t          maxY) const
+{
+    // clip the triangle bounding box to the rectangle
+    minX = std::max(minX, setup.m_MinX);
+    minY = std::max(minY, setup.m_MinY);
+    maxX = std::min(maxX, setup.m_MaxX);
+    maxY = std::min(maxY, setup.m_MaxY);
+
+    if (minX > maxX || minY > maxY)
+        return;
+
+    // small triangle? Walk its bounding box quads directly, testing its blocks would cost more than it saves
+    if (setup.m_MaxX - setup.m_MinX < m_BlockSize && setup.m_MaxY - setup.m_MinY < m_BlockSize)
+    {
+        // quads are aligned on even screen coordinates
+        const std::size_t startX = setup.m_MinX & ~(std::size_t)1;
+        const std::size_t startY = setup.m_MinY & ~(std::size_t)1;
+
+        // hidden by the already drawn geometry?
+        if (IsHidden(frame, setup, minX, minY, maxX, maxY))
+            return;
+
+        TriangleSetup::IValues origin;
+        setup.GetValues(startX, startY, origin);
+
+        RasterizeQuads(frame, setup, origin, startX, startY, minX, minY, maxX, maxY, false);
+
+        // the depth is unchanged on the shading pass
+        if (frame.m_Pass == IEPass::Shading)
+            return;
+
+        // the drawn blocks farthest depth may have changed
+        for (std::size_t blockY = minY / m_BlockSize; blockY <= maxY / m_BlockSize; ++blockY)
+            for (std::size_t blockX = minX / m_BlockSize; blockX <= maxX / m_BlockSize; ++blockX)
+                frame.m_pHiZStale[blockY * m_BlocksX + blockX] = true;
+
+        return;
+    }
 
-                // calculate the pixel index to draw on the render buffer
-                const std::size_t pixelIndex = y * m_Width + x;
+    // the triangle depth is within its vertex depth range. If the range is also within the clipping planes,
+    // all the covered pixels nearer than the depth buffer are drawn, and the depth range bounds their new depth
+    const bool depthInRange = setup.m_MinZ >= m_Near && setup.m_MaxZ <= m_Far;
 
-                // depth test
-                if (z >= m_Near && z <= m_Far && z < m_pZBuffer[pixelIndex])
+    // distance between a block first and last pixels
+    const std::int64_t blockExtent = (std::int64_t)m_BlockSize - 1;
+
+    // walk the blocks overlapping the rectangle, they are aligned on the block size in screen coordinates
+    for (std::size_t blockY = minY & ~(m_BlockSize - 1); blockY <= maxY; blockY += m_BlockSize)
+        for (std::size_t blockX = minX & ~(m_BlockSize - 1); blockX <= maxX; blockX += m_BlockSize)
+        {
+            const std::size_t blockIndex = (blockY / m_BlockSize) * m_BlocksX + blockX / m_BlockSize;
+
+            // block already hidden by nearer geometry? The depth test would fail on all its pixels
+            if (IsHidden(frame, setup, blockX / m_BlockSize, blockY / m_BlockSize))
+                continue;
+
+            TriangleSetup::IValues origin;
+
+            // calculate the equation values on the block first pixel. They are calculated from the block position
+            // only, so the result doesn't depend on the rectangle in which the triangle is drawn
+            setup.GetValues(blockX, blockY, origin);
+
+            bool outside = false;
+            bool covered = true;
+
+            // test the block against each edge. As the equations are linear, their min and max values inside the
+            // block are on its corners
+            for (std::size_t i = 0; i < 3; ++i)
+            {
+                const std::int64_t dx = setup.m_Edge[i].m_A * blockExtent;
+                const std::int64_t dy = setup.m_Edge[i].m_B * blockExtent;
+
+                // block fully outside this edge?
+                if (origin.m_Edge[i] + std::max(dx, (std::int64_t)0) + std::max(dy, (std::int64_t)0) < 0)
                 {
-                    // update depth buffer
-                    m_pZBuffer[pixelIndex] = z;
-
-                    if (m_HasTexture)
-                    {
-                        // calculate perspective-correct texture coordinates
-                        float u = ((texCoord[0].m_X * w0) + (texCoord[1].m_X * w1) + (texCoord[2].m_X * w2)) * z;
-                        float v = ((texCoord[0].m_Y * w0) + (texCoord[1].m_Y * w1) + (texCoord[2].m_Y * w2)) * z;
-
-                        // wrap coordinates (handle values outside 0-1)
-                        u = u - std::floorf(u);
-                        v = v - std::floorf(v);
-
-                        // clamp to prevent out-of-bounds access
-                        std::size_t tx = (std::size_t)std::floorf(u * (float)m_TexWidth);
-                        std::size_t ty = (std::size_t)std::floorf(v * (float)m_TexHeight);
-
-                        // clamp to valid range
-                        if (tx >= m_TexWidth)
-                            tx = m_TexWidth - 1;
-
-                        if (ty >= m_TexHeight)
-                            ty = m_TexHeight - 1;
-
-                        // calculate the texture line width
-                        const std::size_t line = m_TexWidth * m_TexBPP;
-
-                        // calculate the pixel index to get
-                        const std::size_t texIndex = (ty * line) + (tx * m_TexBPP);
-
-                        // get the pixel color from texture
-                        const BYTE b = m_pTexture[texIndex];
-                        const BYTE g = m_pTexture[texIndex + 1];
-                        const BYTE r = m_pTexture[texIndex + 2];
-
-                        // write pixel (BGR format for Windows DIB)
-                        m_pPixels[pixelIndex] = (b << 16) | (g << 8) | r;
-                    }
-                    else
-                        // draw a white pixel by default
-                        m_pPixels[pixelIndex] = 0xFFFFFF;
+                    outside = true;
+                    break;
                 }
+
+                // block partially outside this edge?
+                if (origin.m_Edge[i] + std::min(dx, (std::int64_t)0) + std::min(dy, (std::int64_t)0) < 0)
+                    covered = false;
+            }
+
+            // trivial reject
+            if (outside)
+                continue;
+
+            // draw the block quads, without coverage test if the block is fully inside the triangle
+            RasterizeQuads(frame,
+                           setup,
+                           origin,
+                           blockX,
+                           blockY,
+                           std::max(minX, blockX),
+                           std::max(minY, blockY),
+                           std::min(maxX, blockX + m_BlockSize - 1),
+                           std::min(maxY, blockY + m_BlockSize - 1),
+                           covered);
+
+            // the block is fully drawn, none of its pixels can now be farther than the triangle. Otherwise its
+            // farthest depth may have changed
+            if (frame.m_Pass == IEPass::Shading)
+                continue;
+
+            if (covered && depthInRange)
+                frame.m_pHiZBuffer[blockIndex] = std::min(frame.m_pHiZBuffer[blockIndex], setup.m_MaxZ);
+            else
+                frame.m_pHiZStale[blockIndex] = true;
+        }
+}
+//---------------------------------------------------------------------------
+bool Renderer::IsHidden(const IFrame&        frame,
+                        const TriangleSetup& setup,
+                        std::size_t          minX,
+                        std::size_t          minY,
+                        std::size_t          maxX,
+                        std::size_t          maxY) const
+{
+    for (std::size_t blockY = minY / m_BlockSize; blockY <= maxY / m_BlockSize; ++blockY)
+        for (std::size_t blockX = minX / m_BlockSize; blockX <= maxX / m_BlockSize; ++blockX)
+            if (!IsHidden(frame, setup, blockX, blockY))
+                return false;
+
+    return true;
+}
+//---------------------------------------------------------------------------
+bool Renderer::IsHidden(const IFrame& frame, const TriangleSetup& setup, std::size_t blockX, std::size_t blockY) const
+{
+    const std::size_t blockIndex = blockY * m_BlocksX + blockX;
+
+    // the stored depth is never nearer than the actual one, so the triangle is hidden if it's farther. On the
+    // shading pass, the pixels at the same depth are drawn, so the triangle should be strictly farther
+    if (frame.m_Pass == IEPass::Shading ? setup.m_MinZ > frame.m_pHiZBuffer[blockIndex] : setup.m_MinZ >= frame.m_pHiZBuffer[blockIndex])
+        return true;
+
+    if (!frame.m_pHiZStale[blockIndex])
+        return false;
+
+    // the stored depth may be too conservative, read the actual one from the z buffer
+    const std::size_t startX = blockX * m_BlockSize;
+    const std::size_t startY = blockY * m_BlockSize;
+    const std::size_t endX   = std::min(startX + m_BlockSize, m_Width);
+    const std::size_t endY   = std::min(startY + m_BlockSize, m_Height);
+
+    float depth = m_Near;
+
+    for (std::size_t y = startY; y < endY; ++y)
+    {
+        const float* pLine = &frame.m_pZBuffer[y * m_Width];
+        depth              = std::max(depth, *std::max_element(pLine + startX, pLine + endX));
+    }
+
+    frame.m_pHiZBuffer[blockIndex] = depth;
+    frame.m_pHiZStale[blockIndex]  = false;
+
+    return frame.m_Pass == IEPass::Shading ? setup.m_MinZ > depth : setup.m_MinZ >= depth;
+}
+//---------------------------------------------------------------------------
+void Renderer::RasterizeQuads(const IFrame&                 frame,
+                              const TriangleSetup&          setup,
+                              const TriangleSetup::IValues& origin,
+                                    std::size_t             originX,
+                                    std::size_t             originY,
+                                    std::size_t             minX,
+                                    std::size_t             minY,
+                                    std::size_t             maxX,
+                                    std::size_t             maxY,
+                                    bool                    covered) const
+{
+    TriangleSetup::IValues stepX;
+    TriangleSetup::IValues stepY;
+    setup.GetStepX(2, stepX);
+    setup.GetStepY(2, stepY);
+
+    TriangleSetup::IValues line = origin;
+
+    // skip the quad lines above the rectangle. The values are always stepped from the origin, so they are the
+    // same whatever the rectangle is
+    std::size_t y = originY;
+
+    for (; y + 1 < minY; y += 2)
+        line.Add(stepY);
+
+    for (; y <= maxY; y += 2, line.Add(stepY))
+    {
+        // mask the quad lines outside the rectangle
+        int lineMask = 0xF;
+
+        if (y < minY)
+            lineMask &= 0xC;
+
+        if (y + 1 > maxY)
+            lineMask &= 0x3;
+
+        TriangleSetup::IValues values = line;
+        std::size_t            x      = originX;
+
+        // skip the quads on the left of the rectangle
+        for (; x + 1 < minX; x += 2)
+            values.Add(stepX);
+
+        for (; x <= maxX; x += 2, values.Add(stepX))
+        {
+            // mask the quad columns outside the rectangle
+            int laneMask = lineMask;
+
+            if (x < minX)
+                laneMask &= 0xA;
+
+            if (x + 1 > maxX)
+                laneMask &= 0x5;
+
+            DrawQuad(frame, setup, values, x, y, laneMask, covered);
+        }
+    }
+}
+//---------------------------------------------------------------------------
+void Renderer::DrawQuad(const IFrame&                 frame,
+                        const TriangleSetup&          setup,
+                        const TriangleSetup::IValues& values,
+                              std::size_t             x,
+                              std::size_t             y,
+                              int                     laneMask,
+                              bool                    covered) const
+{
+    // calculate the pixel indices of the quad lines on the render buffer
+    const std::size_t lineIndex[2] = { y * m_Width + x, (y + 1) * m_Width + x };
+
+    // texture to draw with, if any
+    const ITexture* pTexture = frame.m_pTexture;
+
+    #if RASTERIZER_SIMD
+        const __m128 zero = _mm_setzero_ps();
+
+        // pixels outside the triangle, marked by their sign bit
+        __m128 outside = zero;
+
+        if (!covered)
+        {
+            __m128i top    = _mm_setzero_si128();
+            __m128i bottom = _mm_setzero_si128();
+
+            // calculate the edge values of each quad pixel, as 64 bit lanes, and merge them. A pixel is
+            // outside the triangle if any of its values is negative, i.e. if the merged value sign is set
+            for (std::size_t i = 0; i < 3; ++i)
+            {
+                const __m128i edge = _mm_set1_epi64x(values.m_Edge[i]);
+
+                top    = _mm_or_si128(top,    _mm_add_epi64(edge, _mm_loadu_si128((const __m128i*)&setup.m_Edge[i].m_Quad[0])));
+                bottom = _mm_or_si128(bottom, _mm_add_epi64(edge, _mm_loadu_si128((const __m128i*)&setup.m_Edge[i].m_Quad[2])));
             }
+
+            // gather the lanes high halves, which contain the signs
+            outside = _mm_shuffle_ps(_mm_castsi128_ps(top), _mm_castsi128_ps(bottom), _MM_SHUFFLE(3, 1, 3, 1));
         }
 
+        int mask = ~_mm_movemask_ps(outside) & laneMask;
+
+        if (!mask)
+            return;
+
+        // interpolate 1/z, and convert back to z for depth testing
+        const __m128 qInvZ = _mm_add_ps(_mm_set1_ps(values.m_InvZ), _mm_loadu_ps(setup.m_InvZ.m_Quad));
+        const __m128 z     = _mm_div_ps(_mm_set1_ps(1.0f), qInvZ);
+
+        // read the depth buffer values. Pixels outside the rectangle are never read, as they may be owned by
+        // another worker, or even be outside the buffer
+        __m128 depth;
+
+        if (laneMask == 0xF)
+            depth = _mm_loadh_pi(_mm_loadl_pi(zero, (const __m64*)&frame.m_pZBuffer[lineIndex[0]]),
+                                                    (const __m64*)&frame.m_pZBuffer[lineIndex[1]]);
+        else
+            depth = _mm_set_ps((laneMask & 0x8) ? frame.m_pZBuffer[lineIndex[1] + 1] : 0.0f,
+                               (laneMask & 0x4) ? frame.m_pZBuffer[lineIndex[1]]     : 0.0f,
+                               (laneMask & 0x2) ? frame.m_pZBuffer[lineIndex[0] + 1] : 0.0f,
+                               (laneMask & 0x1) ? frame.m_pZBuffer[lineIndex[0]]     : 0.0f);
+
+        __m128 pass;
+
+        // depth test. On the shading pass, only the pixels which kept their depth since the depth pass are visible
+        if (frame.m_Pass == IEPass::Shading)
+            pass = _mm_and_ps(_mm_cmpeq_ps(z, depth), _mm_cmplt_ps(z, _mm_set1_ps(m_Far)));
+        else
+            pass = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(z, _mm_set1_ps(m_Near)),
+                                         _mm_cmple_ps(z, _mm_set1_ps(m_Far))),
+                                         _mm_cmplt_ps(z, depth));
+
+        mask &= _mm_movemask_ps(pass);
+
+        if (!mask)
+            return;
+
+        // update depth buffer, already up to date on the shading pass
+        if (frame.m_Pass != IEPass::Shading)
+        {
+            if (laneMask == 0xF)
+            {
+                const __m128 newDepth = _mm_blendv_ps(depth, z, _mm_andnot_ps(outside, pass));
+
+                _mm_storel_pi((__m64*)&frame.m_pZBuffer[lineIndex[0]], newDepth);
+                _mm_storeh_pi((__m64*)&frame.m_pZBuffer[lineIndex[1]], newDepth);
+            }
+            else
+            {
+                float zLane[4];
+                _mm_storeu_ps(zLane, z);
+
+                for (int i = 0; i < 4; ++i)
+                    if (mask & (1 << i))
+                        frame.m_pZBuffer[lineIndex[i >> 1] + (i & 1)] = zLane[i];
+            }
+        }
+
+        // nothing else to draw on the depth pass
+        if (frame.m_Pass == IEPass::Depth)
+            return;
+
+        if (!pTexture)
+        {
+            // draw a white pixel by default
+            for (int i = 0; i < 4; ++i)
+                if (mask & (1 << i))
+                    frame.m_pPixels[lineIndex[i >> 1] + (i & 1)] = 0xFFFFFF;
+
+            return;
+        }
+
+        // calculate perspective-correct texture coordinates
+        __m128 u = _mm_mul_ps(_mm_add_ps(_mm_set1_ps(values.m_S), _mm_loadu_ps(setup.m_S.m_Quad)), z);
+        __m128 v = _mm_mul_ps(_mm_add_ps(_mm_set1_ps(values.m_T), _mm_loadu_ps(setup.m_T.m_Quad)), z);
+
+        // wrap coordinates (handle values outside 0-1)
+        u = _mm_sub_ps(u, _mm_floor_ps(u));
+        v = _mm_sub_ps(v, _mm_floor_ps(v));
+
+        // convert to texel coordinates, and clamp them to valid range
+        __m128i tx = _mm_cvttps_epi32(_mm_floor_ps(_mm_mul_ps(u, _mm_set1_ps((float)pTexture->m_Width))));
+        __m128i ty = _mm_cvttps_epi32(_mm_floor_ps(_mm_mul_ps(v, _mm_set1_ps((float)pTexture->m_Height))));
+        tx         = _mm_min_epi32(_mm_max_epi32(tx, _mm_setzero_si128()), _mm_set1_epi32((int)pTexture->m_Width  - 1));
+        ty         = _mm_min_epi32(_mm_max_epi32(ty, _mm_setzero_si128()), _mm_set1_epi32((int)pTexture->m_Height - 1));
+
+        // calculate the texel indices to get
+        const __m128i texIndex = _mm_add_epi32(_mm_mullo_epi32(ty, _mm_set1_epi32((int)(pTexture->m_Width * pTexture->m_BPP))),
+                                               _mm_mullo_epi32(tx, _mm_set1_epi32((int)pTexture->m_BPP)));
+
+        int texIndexLane[4];
+        _mm_storeu_si128((__m128i*)texIndexLane, texIndex);
+
+        for (int i = 0; i < 4; ++i)
+            if (mask & (1 << i))
+            {
+                const unsigned char* pTexel = &pTexture->m_Data[texIndexLane[i]];
+
+                // write pixel (BGR format for Windows DIB)
+                frame.m_pPixels[lineIndex[i >> 1] + (i & 1)] = (pTexel[0] << 16) | (pTexel[1] << 8) | pTexel[2];
+            }
+    #else
+        // process each quad pixel, executing exactly the same operations as the SIMD pipeline
+        for (int i = 0; i < 4; ++i)
+        {
+            if (!(laneMask & (1 << i)))
+                continue;
+
+            // is pixel inside the triangle?
+            if (!covered && !(values.m_Edge[0] + setup.m_Edge[0].m_Quad[i] >= 0 &&
+                              values.m_Edge[1] + setup.m_Edge[1].m_Quad[i] >= 0 &&
+                              values.m_Edge[2] + setup.m_Edge[2].m_Quad[i] >= 0))
+                continue;
+
+            // interpolate 1/z, and convert back to z for depth testing
+            const float z = 1.0f / (values.m_InvZ + setup.m_InvZ.m_Quad[i]);
+
+            // calculate the pixel index to draw on the render buffer
+            const std::size_t pixelIndex = lineIndex[i >> 1] + (i & 1);
+
+            // depth test. On the shading pass, only the pixels which kept their depth since the depth pass are visible
+            if (frame.m_Pass == IEPass::Shading)
+            {
+                if (!(z == frame.m_pZBuffer[pixelIndex] && z < m_Far))
+                    continue;
+            }
+            else
+            {
+                if (!(z >= m_Near && z <= m_Far && z < frame.m_pZBuffer[pixelIndex]))
+                    continue;
+
+                // update depth buffer
+                frame.m_pZBuffer[pixelIndex] = z;
+
+                // nothing else to draw on the depth pass
+                if (frame.m_Pass == IEPass::Depth)
+                    continue;
+            }
+
+            if (!pTexture)
+            {
+                // draw a white pixel by default
+                frame.m_pPixels[pixelIndex] = 0xFFFFFF;
+                continue;
+            }
+
+            // calculate perspective-correct texture coordinates
+            float u = (values.m_S + setup.m_S.m_Quad[i]) * z;
+            float v = (values.m_T + setup.m_T.m_Quad[i]) * z;
+
+            // wrap coordinates (handle values outside 0-1)
+            u = u - std::floorf(u);
+            v = v - std::floorf(v);
+
+            // convert to texel coordinates
+            const float fx = std::floorf(u * (float)pTexture->m_Width);
+            const float fy = std::floorf(v * (float)pTexture->m_Height);
+
+            // clamp to valid range (NaN coordinates are clamped to 0)
+            const std::size_t tx = fx >= 0.0f ? std::min((std::size_t)fx, pTexture->m_Width  - 1) : 0;
+            const std::size_t ty = fy >= 0.0f ? std::min((std::size_t)fy, pTexture->m_Height - 1) : 0;
+
+            // calculate the texel index to get
+            const unsigned char* pTexel = &pTexture->m_Data[(ty * pTexture->m_Width * pTexture->m_BPP) + (tx * pTexture->m_BPP)];
+
+            // write pixel (BGR format for Windows DIB)
+            frame.m_pPixels[pixelIndex] = (pTexel[0] << 16) | (pTexel[1] << 8) | pTexel[2];
+        }
+    #endif
+}
+//---------------------------------------------------------------------------
+void Renderer::BinTriangles(IFrame& frame, const ITriangles& triangles, std::size_t start, std::size_t end) const
+{
+    const std::size_t tileCount = m_TilesX * m_TilesY;
+
+    std::fill(frame.m_BinOffsets.begin(), frame.m_BinOffsets.end(), 0);
+
+    // count the triangles overlapping each tile
+    for (std::size_t i = start; i < end; ++i)
+    {
+        const TriangleSetup& setup = triangles[i];
+
+        for (std::size_t y = setup.m_MinY / m_TileSize; y <= setup.m_MaxY / m_TileSize; ++y)
+            for (std::size_t x = setup.m_MinX / m_TileSize; x <= setup.m_MaxX / m_TileSize; ++x)
+                ++frame.m_BinOffsets[y * m_TilesX + x];
+    }
+
+    // accumulate the counts, each tile offset becomes the end of its bin
+    for (std::size_t i = 1; i < tileCount; ++i)
+        frame.m_BinOffsets[i] += frame.m_BinOffsets[i - 1];
+
+    frame.m_BinOffsets[tileCount] = tileCount ? frame.m_BinOffsets[tileCount - 1] : 0;
+
+    const std::size_t binSize = frame.m_BinOffsets[tileCount];
+
+    // all the bins share the same array, which grows only when more tile overlaps than ever are found. As
+    // this depends on the view, it grows with some margin, and its growths are expected allocations
+    if (frame.m_BinTriangles.capacity() < binSize)
+    {
+        frame.m_BinTriangles.reserve(binSize + binSize / 2);
+        ++frame.m_BinGrowths;
+    }
+
+    frame.m_BinTriangles.resize(binSize);
+
+    // add each triangle to the bins of all the tiles its bounding box overlaps. The bins are filled from
+    // their end and the triangles read backward, so they are kept in their submission order, and the result
+    // doesn't depend on which worker draws which tile. Each tile offset becomes the start of its bin
+    for (std::size_t i = end; i-- > start;)
+    {
+        const TriangleSetup& setup = triangles[i];
+
+        for (std::size_t y = setup.m_MinY / m_TileSize; y <= setup.m_MaxY / m_TileSize; ++y)
+            for (std::size_t x = setup.m_MinX / m_TileSize; x <= setup.m_MaxX / m_TileSize; ++x)
+                frame.m_BinTriangles[--frame.m_BinOffsets[y * m_TilesX + x]] = (std::uint32_t)i;
+    }
+}
+//---------------------------------------------------------------------------
+void Renderer::RasterizeTile(const IFrame& frame, const ITriangles& triangles, std::size_t tile) const
+{
+    // calculate the tile rectangle
+    const std::size_t minX = (tile % m_TilesX) * m_TileSize;
+    const std::size_t minY = (tile / m_TilesX) * m_TileSize;
+    const std::size_t maxX = std::min(minX + m_TileSize, m_Width)  - 1;
+    const std::size_t maxY = std::min(minY + m_TileSize, m_Height) - 1;
+
+    // the tile bin ends where the next one starts
+    for (std::size_t i = frame.m_BinOffsets[tile]; i < frame.m_BinOffsets[tile + 1]; ++i)
+        RasterizeTriangle(frame, triangles[frame.m_BinTriangles[i]], minX, minY, maxX, maxY);
+}
+//---------------------------------------------------------------------------
+bool Renderer::DrawPolygon(const Geometry::Polygon& polygon,
+                           const Math::Vector3F*    normal,
+                           const Math::Vector2F*    st) const
+{
+    TriangleSetup setup;
+
+    // cull and setup the polygon
+    if (!SetupPolygon(polygon, st, setup))
+        return true;
+
+    RasterizeTriangle(m_Frames[0], setup, 0, 0, m_Width - 1, m_Height - 1);
+
     return true;
 }
 //---------------------------------------------------------------------------
@@ -28,18 +28,44 @@
 
 #pragma once
 
+ // std
+#include <vector>
+#include <cstdint>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
  // classes
 #include "Matrix4x4.h"
 #include "Polygon.h"
-#include "WaveFront.h"
+#include "Plane.h"
+#include "MeshCompiler.h"
+#include "MeshQuantizer.h"
+#include "MeshletBuilder.h"
+#include "MeshSimplifier.h"
+#include "Scene.h"
+#include "TriangleSetup.h"
+#include "ThreadPool.h"
 
 // windows
 #define WIN32_LEAN_AND_MEAN
 #define NOMINMAX
 #include <windows.h>
 
+// the pixel pipeline processes 2x2 pixel quads with SSE4.1 instructions. Define RASTERIZER_SIMD to 0
+// to build the scalar pipeline instead, which gives a bit-identical output and may be used to validate it
+#ifndef RASTERIZER_SIMD
+    #if defined(_M_X64) || defined(_M_IX86) || defined(__SSE4_1__)
+        #define RASTERIZER_SIMD 1
+    #else
+        #define RASTERIZER_SIMD 0
+    #endif
+#endif
+
 namespace Rasterizer
 {
+    class CommandList;
+
     /**
     * Software renderer
     *@author Jean-Milost Reymond
@@ -67,6 +93,17 @@ namespace Rasterizer
                 CCW
             };
 
+            /**
+            * Render mode
+            */
+            enum class IERenderMode
+            {
+                Immediate, // each triangle is drawn on the calling thread as soon as its face is read
+                Binned,    // triangles are binned into screen tiles, which are drawn by the worker threads
+                Pipelined  // triangles are binned for the whole frame, and drawn in the background while the
+                           // next frame is prepared
+            };
+
             Renderer();
             virtual ~Renderer();
 
@@ -96,13 +133,86 @@ namespace Rasterizer
             void SetModel(const Math::Matrix4x4F& model);
 
             /**
-            * Loads texture from bitmap data
+            * Loads texture from bitmap data, and selects it
             *@param data - raw RGBA bitmap data (unsigned char*)
             *@param width - texture width
             *@param height - texture height
             *@param bpp - byte per pixels
+            *@return the texture index, to select it again later
+            *@note The textures are kept until the renderer is destroyed
+            */
+            std::size_t LoadTexture(unsigned char* data, std::size_t width, std::size_t height, std::size_t bpp);
+
+            /**
+            * Selects a loaded texture
+            *@param index - texture index, as returned by LoadTexture(). No texture is selected if out of bounds
+            */
+            void SetTexture(std::size_t index);
+
+            /**
+            * Sets the culling mode
+            *@param type - culling type
+            *@param face - culling face
+            */
+            void SetCulling(IECullingType type, IECullingFace face);
+
+            /**
+            * Sets the render mode
+            *@param mode - render mode
+            *@note In pipelined mode, a frame is drawn by a background thread after SwapBuffers() is called, on
+            *      its own color and depth buffers, and shown by the next SwapBuffers() call. The frame being
+            *      prepared when the mode changes is dropped
+            */
+            void SetRenderMode(IERenderMode mode);
+
+            /**
+            * Gets the render mode
+            *@return the render mode
+            */
+            IERenderMode GetRenderMode() const;
+
+            /**
+            * Sets if the meshes are rendered with a depth pre-pass
+            *@param value - if true, each mesh is first rendered in the depth buffer only, then only its visible
+            *               pixels are shaded. Worth it with a high depth complexity
+            */
+            void SetDepthPrepass(bool value);
+
+            /**
+            * Gets if the meshes are rendered with a depth pre-pass
+            *@return true if the meshes are rendered with a depth pre-pass, otherwise false
             */
-            void LoadTexture(unsigned char* data, std::size_t width, std::size_t height, std::size_t bpp);
+            bool GetDepthPrepass() const;
+
+            /**
+            * Sets the level of detail threshold
+            *@param pixels - max distance on the screen between a rendered level of detail and its source mesh,
+            *                in pixels. The coarsest level within this distance is rendered
+            */
+            void SetLodThreshold(float pixels);
+
+            /**
+            * Gets the level of detail threshold
+            *@return the max distance on the screen between a rendered level of detail and its source mesh, in pixels
+            */
+            float GetLodThreshold() const;
+
+            /**
+            * Sets if the rendered content reached its steady state
+            *@param value - if true, the next frames render the same meshes as the previous ones, so they should
+            *               no longer allocate once the renderer buffers grew to fit them
+            *@note If ALLOCATION_COUNTER is enabled, each frame is then asserted to not allocate, after a few
+            *      warm-up frames
+            */
+            void SetSteadyState(bool value);
+
+            /**
+            * Gets the number of heap allocations made to render the last complete frame
+            *@return the allocation count, always 0 if ALLOCATION_COUNTER isn't enabled
+            *@note In pipelined mode, the last complete frame is the one drawn by the back end before the last
+            *      SwapBuffers() call. The tile bins growth, which depends on the view, isn't counted
+            */
+            std::size_t GetLastFrameAllocations() const;
 
             /**
             * Makes this context current for rendering
@@ -112,43 +222,250 @@ namespace Rasterizer
             /**
             * Clears the renderer buffer
             *@param color - fill color
+            *@note In pipelined mode, the buffers are cleared when the frame is drawn
             */
-            void Clear(COLORREF color) const;
+            void Clear(COLORREF color);
 
             /**
             * Renders the mesh
-            * @param mesh The mesh to render
+            * @param mesh The compiled mesh to render
+            *@note Nothing is allocated once the internal buffers are large enough for the mesh, which is
+            *      asserted in debug builds. The mesh is skipped if its bounding volumes are outside the
+            *      view frustum
+            */
+            void Render(const Model::MeshCompiler::IMeshView& mesh);
+
+            /**
+            * Renders a mesh split in meshlets
+            *@param mesh - compiled mesh to render
+            *@param meshlets - mesh meshlets
+            *@note The meshlets outside the view frustum, or facing away from the camera, are rejected before
+            *      their vertices are transformed. The meshlet vertices are transformed once per meshlet using them
             */
-            void Render(const Model::WaveFront::IMesh& mesh) const;
+            void Render(const Model::MeshCompiler::IMeshView& mesh, const Model::MeshletBuilder::IMeshlets& meshlets);
+
+            /**
+            * Renders a mesh level of detail
+            *@param mesh - compiled mesh to render
+            *@param lods - mesh levels of detail
+            *@note The level is selected each frame, from its error projected on the screen where the mesh
+            *      bounding sphere is the nearest to the camera
+            */
+            void Render(const Model::MeshCompiler::IMeshView& mesh, const Model::MeshSimplifier::ILods& lods);
+
+            /**
+            * Renders a scene
+            *@param scene - scene to render, should be up to date
+            *@note The instances outside the view frustum are culled by the scene hierarchy, the others are
+            *      rendered as single meshes, with their meshlets or levels of detail if any. The meshlets are
+            *      only used with the source mesh level. The renderer model matrix is ignored
+            */
+            void Render(const Model::Scene& scene);
+
+            /**
+            * Renders several instances of a mesh
+            *@param mesh - compiled mesh to render
+            *@param pMatrices - instance model matrices
+            *@param count - instance count
+            *@note The mesh positions are read once for all the instances, and the vertices of several small
+            *      instances are transformed together, to be shared between the workers. The instances outside
+            *      the view frustum are skipped. The renderer model matrix is ignored
+            */
+            void RenderInstanced(const Model::MeshCompiler::IMeshView& mesh,
+                                 const Math::Matrix4x4F*               pMatrices,
+                                       std::size_t                     count);
+
+            /**
+            * Renders a quantized mesh
+            *@param mesh - quantized mesh to render
+            *@note The positions are dequantized by the render matrix, the texture coordinates and normals
+            *      while the triangles are read. The mesh is culled like the compiled ones
+            */
+            void Render(const Model::MeshQuantizer::IMesh& mesh);
+
+            /**
+            * Executes a command list
+            *@param commands - command list to execute
+            *@note The commands are sorted by texture, then front to back, so the textures are selected once
+            *      and the nearest meshes hide the farthest ones pixels before they are shaded. The renderer
+            *      model matrix, texture and culling mode are restored after
+            */
+            void Execute(const CommandList& commands);
 
             /**
             * Swaps buffers to display rendered frame
+            *@note In pipelined mode, the prepared frame starts to be drawn, and the previous one is displayed
             */
-            void SwapBuffers() const;
+            void SwapBuffers();
 
         private:
-            Math::Matrix4x4F m_Projection;
-            Math::Matrix4x4F m_View;
-            Math::Matrix4x4F m_Model;
-            IECullingType    m_CullingType = IECullingType::Back;
-            IECullingFace    m_CullingFace = IECullingFace::CW;
-            RECT             m_ScreenRect  = { 0 };
-            HWND             m_hWnd        = nullptr;
-            HDC              m_hDC         = nullptr;
-            HDC              m_hMemDC      = nullptr;
-            HBITMAP          m_hCanvas     = nullptr;
-            unsigned char*   m_pTexture    = nullptr;
-            DWORD*           m_pPixels     = nullptr;
-            float*           m_pZBuffer    = nullptr;
-            float            m_Near        = 0.1f;
-            float            m_Far         = 1000.0f;
-            std::size_t      m_TexWidth    = 0;
-            std::size_t      m_TexHeight   = 0;
-            std::size_t      m_TexBPP      = 0;
-            std::size_t      m_Width       = 0;
-            std::size_t      m_Height      = 0;
-            bool             m_HasTexture  = false;
-            bool             m_Initialized = false;
+            static const std::size_t m_TileSize  = 64; // should be a multiple of the block size
+            static const std::size_t m_BlockSize = 8;  // should be a power of 2
+
+            /**
+            * Rasterization pass
+            */
+            enum class IEPass
+            {
+                Full,   // depth test, depth write and shading
+                Depth,  // depth test and depth write only
+                Shading // shading of the pixels whose depth equals the depth buffer one
+            };
+
+            /**
+            * Mesh location relatively to the view frustum
+            */
+            enum class IEContainment
+            {
+                Outside,
+                Intersecting,
+                Inside
+            };
+
+            static const std::size_t m_VertexBatchSize   = 1024;  // vertices transformed by a worker at once
+            static const std::size_t m_InstanceBatchSize = 4096;  // max vertices of the instances transformed together
+
+            /**
+            * Vertex positions, in structure of arrays form
+            */
+            struct IVertexStreams
+            {
+                std::vector<float> m_X;
+                std::vector<float> m_Y;
+                std::vector<float> m_Z;
+
+                /**
+                * Resizes the streams
+                *@param count - vertex count
+                */
+                inline void Resize(std::size_t count)
+                {
+                    m_X.resize(count);
+                    m_Y.resize(count);
+                    m_Z.resize(count);
+                }
+            };
+
+            /**
+            * Mesh instance to render
+            */
+            struct IInstance
+            {
+                Math::Matrix4x4F m_Matrix; // render matrix
+                bool             m_Inside; // if true, the instance is fully inside the view frustum
+            };
+
+            /**
+            * Texture
+            */
+            struct ITexture
+            {
+                std::vector<unsigned char> m_Data;
+                std::size_t                m_Width  = 0;
+                std::size_t                m_Height = 0;
+                std::size_t                m_BPP    = 0;
+            };
+
+            /**
+            * Command to execute, with its sort key
+            */
+            struct ISortedCommand
+            {
+                std::uint64_t m_Key;   // texture index on the high 32 bits, depth on the low ones
+                std::uint32_t m_Index; // command index in its list
+            };
+
+            typedef std::vector<TriangleSetup>  ITriangles;
+            typedef std::vector<IInstance>      IInstances;
+            typedef std::vector<ITexture>       ITextures;
+            typedef std::vector<ISortedCommand> ISortedCommands;
+            typedef std::vector<std::uint32_t>  IIndices;
+            typedef Model::Scene::IVisibleInstances IVisibleInstances;
+
+            /**
+            * Draw recorded in a pipelined frame
+            */
+            struct IDraw
+            {
+                std::uint32_t m_End;          // end of the draw triangles, which start where the previous draw ends
+                std::size_t   m_Texture;      // texture index
+                bool          m_DepthPrepass; // if true, the triangles are drawn with a depth pre-pass
+            };
+
+            typedef std::vector<IDraw> IDraws;
+
+            /**
+            * Frame buffers and draw state, and frame drawn in pipelined mode. The other modes draw in the
+            * first frame. The thread drawing a frame only writes in it, so the back end never shares its
+            * state with the front end
+            */
+            struct IFrame
+            {
+                HBITMAP         m_hCanvas     = nullptr;
+                DWORD*          m_pPixels     = nullptr;
+                float*          m_pZBuffer    = nullptr;
+                float*          m_pHiZBuffer  = nullptr; // farthest depth of each block, may be farther than the actual one
+                bool*           m_pHiZStale   = nullptr; // if true, the block farthest depth may be refined from the z buffer
+                const ITexture* m_pTexture    = nullptr; // texture to draw with, none if nullptr
+                IIndices        m_BinOffsets;            // start of each tile bin in m_BinTriangles, plus their end
+                IIndices        m_BinTriangles;          // triangle indices of all the tile bins, one after the other
+                ITriangles      m_Triangles;
+                IDraws          m_Draws;
+                IEPass          m_Pass        = IEPass::Full;
+                std::size_t     m_Allocations = 0;       // heap allocations made to prepare and draw the frame
+                std::size_t     m_BinGrowths  = 0;       // tile bins growths while drawing the frame, expected
+                COLORREF        m_ClearColor  = 0;
+                bool            m_Clear       = false; // if true, the buffers are cleared before the frame is drawn
+                bool            m_Drawn       = false; // if true, the frame was drawn and may be displayed
+            };
+
+            Threading::ThreadPool   m_ThreadPool;
+            IFrame                  m_Frames[2];
+            IDraws                  m_Draws;   // draws of the frame being prepared in pipelined mode
+            std::thread             m_BackEnd; // draws the pipelined frames
+            std::mutex              m_BackEndMutex;
+            std::condition_variable m_BackEndCondition;
+            IFrame*                 m_pSubmittedFrame = nullptr; // frame to draw, or being drawn, by the back end
+            IVertexStreams          m_ModelVertices;
+            IVertexStreams          m_ScreenVertices;
+            ITriangles              m_Triangles;
+            IIndices                m_VisibleMeshlets;
+            IVisibleInstances       m_VisibleInstances;
+            IInstances              m_Instances;
+            ITextures               m_Textures;
+            ISortedCommands         m_SortedCommands;
+            Math::Matrix4x4F        m_Projection;
+            Math::Matrix4x4F        m_View;
+            Math::Matrix4x4F        m_Model;
+            IECullingType           m_CullingType     = IECullingType::Back;
+            IECullingFace           m_CullingFace     = IECullingFace::CW;
+            IERenderMode            m_RenderMode      = IERenderMode::Immediate;
+            RECT                    m_ScreenRect      = { 0 };
+            HWND                    m_hWnd            = nullptr;
+            HDC                     m_hDC             = nullptr;
+            HDC                     m_hMemDC          = nullptr;
+            std::size_t             m_Texture         = 0;       // selected texture index
+            std::size_t             m_PreparedFrame   = 0;       // frame prepared in pipelined mode
+            COLORREF                m_ClearColor      = 0;
+            float                   m_Near            = 0.1f;
+            float                   m_Far             = 1000.0f;
+            float                   m_LodThreshold    = 1.0f;
+            std::size_t             m_Width           = 0;
+            std::size_t             m_Height          = 0;
+            std::size_t             m_TilesX          = 0;
+            std::size_t             m_TilesY          = 0;
+            std::size_t             m_BlocksX         = 0;
+            std::size_t             m_BlocksY         = 0;
+            bool                    m_DepthPrepass    = false;
+            bool                    m_Clear           = false;   // if true, the prepared frame should be cleared
+            bool                    m_SteadyState     = false;
+            bool                    m_StopBackEnd     = false;
+            bool                    m_Initialized     = false;
+
+            // heap allocations, counted if ALLOCATION_COUNTER is enabled
+            std::size_t             m_FrameAllocations     = 0; // made to prepare the frame
+            std::size_t             m_LastFrameAllocations = 0; // made to render the last complete frame
+            std::size_t             m_SteadyFrames         = 0; // frames rendered since the steady state was reached
 
             /**
             * Transform a vertex into screen coordinates
@@ -160,16 +477,349 @@ namespace Rasterizer
                                            const Math::Matrix4x4F& matrix) const;
 
             /**
-            * Draws a polygon
-            *@param polygon - polygon
-            *@param normal - polygon normal (array of 3 items)
+            * Gets the allocation count from which the frame allocations are measured
+            *@return the allocation count, always 0 if ALLOCATION_COUNTER isn't enabled
+            */
+            std::size_t GetAllocationCount() const;
+
+            /**
+            * Creates the buffers of a frame
+            *@param frame - frame to create
+            *@return true on success, otherwise false
+            */
+            bool CreateFrame(IFrame& frame);
+
+            /**
+            * Deletes the buffers of a frame
+            *@param frame - frame to delete
+            */
+            void DeleteFrame(IFrame& frame);
+
+            /**
+            * Clears the buffers of a frame
+            *@param frame - frame owning the buffers
+            *@param color - fill color
+            */
+            void ClearBuffers(const IFrame& frame, COLORREF color) const;
+
+            /**
+            * Selects the texture to draw a frame with
+            *@param frame - frame to draw
+            *@param index - texture index, no texture is used if out of bounds
+            */
+            void BindTexture(IFrame& frame, std::size_t index) const;
+
+            /**
+            * Submits the prepared frame to the back end, and displays the previous one
+            */
+            void SubmitFrame();
+
+            /**
+            * Waits until the back end finished to draw the submitted frame, if any
+            */
+            void WaitFrame();
+
+            /**
+            * Back end thread loop, draws the submitted frames until the renderer is destroyed
+            */
+            void RunBackEnd();
+
+            /**
+            * Draws a pipelined frame
+            *@param frame - frame to draw
+            */
+            void DrawFrame(IFrame& frame);
+
+            /**
+            * Gets the view frustum planes
+            *@param matrix - render matrix
+            *@param[out] pPlanes - frustum planes (array of 6 items), in the render matrix source space. Their
+            *                      normals are normalized and point inside the frustum
+            *@note The frustum contains the points whose screen position is inside the screen, and whose
+            *      depth is between the near and far planes, as rasterized
+            */
+            void GetFrustum(const Math::Matrix4x4F& matrix, Geometry::PlaneF* pPlanes) const;
+
+            /**
+            * Locates a mesh relatively to the view frustum
+            *@param box - mesh bounding box
+            *@param sphere - mesh bounding sphere
+            *@param matrix - render matrix
+            *@return the mesh location, conservative: a mesh located as intersecting may be inside or outside
+            */
+            IEContainment GetContainment(const Model::MeshCompiler::IBox&    box,
+                                         const Model::MeshCompiler::ISphere& sphere,
+                                         const Math::Matrix4x4F&             matrix) const;
+
+            /**
+            * Selects a mesh level of detail
+            *@param lods - mesh levels of detail
+            *@param sphere - mesh bounding sphere
+            *@param matrix - render matrix
+            *@return the selected level index, 0 for the source mesh
+            */
+            std::size_t SelectLod(const Model::MeshSimplifier::ILods& lods,
+                                  const Model::MeshCompiler::ISphere& sphere,
+                                  const Math::Matrix4x4F&             matrix) const;
+
+            /**
+            * Renders the mesh triangles
+            *@param pVertices - mesh vertices, either compiled or quantized
+            *@param vertexCount - vertex count
+            *@param pIndices - mesh indices, each group of 3 indices is a triangle
+            *@param indexCount - index count
+            *@param matrix - render matrix, transforming the vertex positions to clip space
+            *@param inside - if true, the mesh is fully inside the view frustum, and its triangles aren't
+            *                tested against the near and far planes
+            */
+            template <class TVertex>
+            void RenderMesh(const TVertex*          pVertices,
+                                  std::size_t       vertexCount,
+                            const std::uint32_t*    pIndices,
+                                  std::size_t       indexCount,
+                            const Math::Matrix4x4F& matrix,
+                                  bool              inside);
+
+            /**
+            * Renders the visible meshlets triangles
+            *@param mesh - compiled mesh
+            *@param meshlets - mesh meshlets
+            *@param matrix - render matrix
+            *@param inside - if true, the mesh is fully inside the view frustum, and its meshlets and triangles
+            *                aren't tested against it
+            */
+            void RenderMeshlets(const Model::MeshCompiler::IMeshView&    mesh,
+                                const Model::MeshletBuilder::IMeshlets& meshlets,
+                                const Math::Matrix4x4F&                 matrix,
+                                      bool                              inside);
+
+            /**
+            * Gets the eye position, from which the vertices are projected on the screen
+            *@param matrix - render matrix
+            *@return the eye position, in the render matrix source space
+            */
+            Math::Vector3F GetEye(const Math::Matrix4x4F& matrix) const;
+
+            /**
+            * Starts a new triangle list
+            *@param count - maximum triangle count in the list
+            */
+            void BeginTriangles(std::size_t count);
+
+            /**
+            * Adds a triangle to the list, or draws it immediately in immediate mode without depth pre-pass
+            *@param polygon - polygon in screen coordinates
+            *@param normal - polygon normals (array of 3 items)
             *@param st - polygon texture coordinates (array of 3 items)
+            *@param inside - if true, the polygon is known to be inside the view frustum
+            */
+            void AddTriangle(const Geometry::Polygon& polygon,
+                             const Math::Vector3F*    normal,
+                             const Math::Vector2F*    st,
+                                   bool               inside);
+
+            /**
+            * Draws the triangle list
+            */
+            void DrawTriangles();
+
+            /**
+            * Rasterizes a range of set up triangles, with the passes they need
+            *@param frame - frame to draw in
+            *@param triangles - set up triangles
+            *@param start - first triangle to rasterize
+            *@param end - end of the triangles to rasterize
+            *@param depthPrepass - if true, the triangles are rasterized with a depth pre-pass
+            */
+            void RasterizeTriangles(      IFrame&     frame,
+                                    const ITriangles& triangles,
+                                          std::size_t start,
+                                          std::size_t end,
+                                          bool        depthPrepass);
+
+            /**
+            * Transforms the mesh vertices into screen coordinates, once for all the triangles sharing them
+            *@param pVertices - mesh vertices, either compiled or quantized
+            *@param count - vertex count
+            *@param matrix - matrix
+            *@note The transformed vertices are written in m_ScreenVertices, in the same order. They are the same
+            *      as the TransformVertex() ones
+            */
+            template <class TVertex>
+            void TransformVertices(const TVertex*          pVertices,
+                                         std::size_t       count,
+                                   const Math::Matrix4x4F& matrix);
+
+            /**
+            * Converts the mesh vertex positions to structure of arrays
+            *@param pVertices - mesh vertices, either compiled or quantized
+            *@param count - vertex count
+            *@note The positions are written in m_ModelVertices, in the same order
+            */
+            template <class TVertex>
+            void LoadPositions(const TVertex* pVertices, std::size_t count);
+
+            /**
+            * Transforms a range of vertex positions into screen coordinates
             *@param matrix - matrix
+            *@param modelStart - first position to transform in m_ModelVertices
+            *@param screenStart - first transformed vertex in m_ScreenVertices
+            *@param count - position count to transform
+            */
+            void ProjectVertexRange(const Math::Matrix4x4F& matrix,
+                                          std::size_t       modelStart,
+                                          std::size_t       screenStart,
+                                          std::size_t       count);
+
+            /**
+            * Transforms a range of vertices into screen coordinates
+            *@param pVertices - mesh vertices, either compiled or quantized
+            *@param pIndices - indices of the vertices to transform, if nullptr the vertices are transformed in order
+            *@param start - first vertex to transform, in the indices if any, otherwise in the vertices
+            *@param end - vertex following the last one to transform
+            *@param matrix - matrix
+            *@note The transformed vertices are written in m_ScreenVertices, between start and end
+            */
+            template <class TVertex>
+            void TransformVertexRange(const TVertex*          pVertices,
+                                      const std::uint32_t*    pIndices,
+                                            std::size_t       start,
+                                            std::size_t       end,
+                                      const Math::Matrix4x4F& matrix);
+
+            /**
+            * Culls a polygon, and setups it for rasterization
+            *@param polygon - polygon in screen coordinates
+            *@param st - polygon texture coordinates (array of 3 items)
+            *@param[out] setup - triangle setup
+            *@return true if the polygon should be rasterized, false if culled
+            */
+            bool SetupPolygon(const Geometry::Polygon& polygon,
+                              const Math::Vector2F*    st,
+                                    TriangleSetup&     setup) const;
+
+            /**
+            * Rasterizes a range of set up triangles on the frame current pass
+            *@param frame - frame to draw in
+            *@param triangles - set up triangles, should be binned in binned or pipelined mode
+            *@param start - first triangle to rasterize
+            *@param end - end of the triangles to rasterize
+            */
+            void RasterizePass(const IFrame& frame, const ITriangles& triangles, std::size_t start, std::size_t end);
+
+            /**
+            * Rasterizes a triangle inside a screen rectangle, by walking the blocks its bounding box overlaps
+            *@param frame - frame to draw in
+            *@param setup - triangle setup
+            *@param minX - rectangle left pixel
+            *@param minY - rectangle top pixel
+            *@param maxX - rectangle right pixel (included)
+            *@param maxY - rectangle bottom pixel (included)
+            */
+            void RasterizeTriangle(const IFrame&        frame,
+                                   const TriangleSetup& setup,
+                                   std::size_t          minX,
+                                   std::size_t          minY,
+                                   std::size_t          maxX,
+                                   std::size_t          maxY) const;
+
+            /**
+            * Checks if a triangle is hidden by the already drawn geometry in all the blocks of a screen rectangle
+            *@param frame - frame to draw in
+            *@param setup - triangle setup
+            *@param minX - rectangle left pixel
+            *@param minY - rectangle top pixel
+            *@param maxX - rectangle right pixel (included)
+            *@param maxY - rectangle bottom pixel (included)
+            *@return true if the triangle is hidden, false if it may be visible
+            */
+            bool IsHidden(const IFrame&        frame,
+                          const TriangleSetup& setup,
+                          std::size_t          minX,
+                          std::size_t          minY,
+                          std::size_t          maxX,
+                          std::size_t          maxY) const;
+
+            /**
+            * Checks if a triangle is hidden by the already drawn geometry in a block
+            *@param frame - frame to draw in
+            *@param setup - triangle setup
+            *@param blockX - block x coordinate, in blocks
+            *@param blockY - block y coordinate, in blocks
+            *@return true if the triangle is hidden, false if it may be visible
+            *@note The block farthest depth is refined from the z buffer if it's stale and doesn't hide the triangle
+            */
+            bool IsHidden(const IFrame& frame, const TriangleSetup& setup, std::size_t blockX, std::size_t blockY) const;
+
+            /**
+            * Rasterizes the 2x2 pixel quads of a triangle inside a screen rectangle
+            *@param frame - frame to draw in
+            *@param setup - triangle setup
+            *@param origin - equation values on the origin pixel
+            *@param originX - origin pixel x coordinate, from which the quads are stepped, should be even
+            *@param originY - origin pixel y coordinate, from which the quads are stepped, should be even
+            *@param minX - rectangle left pixel, should be on or after the origin
+            *@param minY - rectangle top pixel, should be on or after the origin
+            *@param maxX - rectangle right pixel (included)
+            *@param maxY - rectangle bottom pixel (included)
+            *@param covered - if true, the rectangle is known to be fully inside the triangle
+            */
+            void RasterizeQuads(const IFrame&                 frame,
+                                const TriangleSetup&          setup,
+                                const TriangleSetup::IValues& origin,
+                                      std::size_t             originX,
+                                      std::size_t             originY,
+                                      std::size_t             minX,
+                                      std::size_t             minY,
+                                      std::size_t             maxX,
+                                      std::size_t             maxY,
+                                      bool                    covered) const;
+
+            /**
+            * Draws a 2x2 pixel quad of a triangle
+            *@param frame - frame to draw in
+            *@param setup - triangle setup
+            *@param values - equation values on the quad top left pixel
+            *@param x - quad left pixel, should be even
+            *@param y - quad top pixel, should be even
+            *@param laneMask - mask of the quad pixels to consider, bit 0 for top left, 1 for top right,
+            *                  2 for bottom left and 3 for bottom right
+            *@param covered - if true, the quad is known to be fully inside the triangle and isn't tested
+            */
+            void DrawQuad(const IFrame&                 frame,
+                          const TriangleSetup&          setup,
+                          const TriangleSetup::IValues& values,
+                                std::size_t             x,
+                                std::size_t             y,
+                                int                     laneMask,
+                                bool                    covered) const;
+
+            /**
+            * Bins a range of set up triangles into the screen tiles they overlap
+            *@param frame - frame owning the bins
+            *@param triangles - set up triangles
+            *@param start - first triangle to bin
+            *@param end - end of the triangles to bin
+            */
+            void BinTriangles(IFrame& frame, const ITriangles& triangles, std::size_t start, std::size_t end) const;
+
+            /**
+            * Rasterizes a screen tile
+            *@param frame - frame to draw in, owning the bins
+            *@param triangles - binned triangles
+            *@param tile - tile index
+            */
+            void RasterizeTile(const IFrame& frame, const ITriangles& triangles, std::size_t tile) const;
+
+            /**
+            * Draws a polygon in the first frame
+            *@param polygon - polygon in screen coordinates
+            *@param normal - polygon normal (array of 3 items)
+            *@param st - polygon texture coordinates (array of 3 items)
             *@return true on success, otherwise false
             */
-            bool DrawPolygon(const Geometry::Polygon&           polygon,
-                             const std::vector<Math::Vector3F>& normal,
-                             const std::vector<Math::Vector2F>& st,
-                             const Math::Matrix4x4F&            matrix) const;
+            bool DrawPolygon(const Geometry::Polygon& polygon,
+                             const Math::Vector3F*    normal,
+                             const Math::Vector2F*    st) const;
     };
 }
@@ -0,0 +1,164 @@
+/****************************************************************************
+ * ==> ThreadPool ----------------------------------------------------------*
+ ****************************************************************************
+ * Description: Worker thread pool                                          *
+ * Developer:   Jean-Milost Reymond                                         *
+ ****************************************************************************
+ * MIT License                                                              *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files (the            *
+ * "Software"), to deal in the Software without restriction, including      *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sub-license, and/or sell copies of the Software, and to      *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+#include "ThreadPool.h"
+
+// std
+#include <algorithm>
+
+// classes
+#include "AllocationCounter.h"
+
+using namespace Threading;
+
+//---------------------------------------------------------------------------
+// ThreadPool
+//---------------------------------------------------------------------------
+ThreadPool::ThreadPool(std::size_t threadCount)
+{
+    if (!threadCount)
+        threadCount = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+
+    // the calling thread is also a worker
+    for (std::size_t i = 1; i < threadCount; ++i)
+        m_Workers.emplace_back(&ThreadPool::WorkerLoop, this);
+}
+//---------------------------------------------------------------------------
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Exit = true;
+    }
+
+    m_JobAdded.notify_all();
+
+    for (std::size_t i = 0; i < m_Workers.size(); ++i)
+        m_Workers[i].join();
+}
+//---------------------------------------------------------------------------
+void ThreadPool::Run(std::size_t count, ITask task, void* pContext)
+{
+    if (!count)
+        return;
+
+    // no worker, or nothing to share? Just process the items on the calling thread
+    if (m_Workers.empty() || count == 1)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+            task(pContext, i);
+
+        return;
+    }
+
+    // the job lives on the stack, the workers may only access it while they are registered as users
+    IJob job;
+    job.m_Task     = task;
+    job.m_pContext = pContext;
+    job.m_Count    = count;
+
+    // publish the job
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        job.m_pNext = m_pJobs;
+        m_pJobs     = &job;
+    }
+
+    m_JobAdded.notify_all();
+
+    // help processing the items
+    Execute(job);
+
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    // unpublish the job, no new worker can take it from now
+    for (IJob** ppJob = &m_pJobs; *ppJob; ppJob = &(*ppJob)->m_pNext)
+        if (*ppJob == &job)
+        {
+            *ppJob = job.m_pNext;
+            break;
+        }
+
+    // all the items are claimed, wait until the workers processing the last ones are done
+    m_JobReleased.wait(lock, [&job]() { return !job.m_Users; });
+
+    // the workers allocated on behalf of the calling thread
+    Debug::AllocationCounter::AddThread(job.m_Allocations);
+}
+//---------------------------------------------------------------------------
+void ThreadPool::WorkerLoop()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+
+    while (true)
+    {
+        IJob* pJob = nullptr;
+
+        // search for a job having items to process
+        for (IJob* pCurrent = m_pJobs; pCurrent; pCurrent = pCurrent->m_pNext)
+            if (pCurrent->m_Next.load() < pCurrent->m_Count)
+            {
+                pJob = pCurrent;
+                break;
+            }
+
+        if (!pJob)
+        {
+            if (m_Exit)
+                return;
+
+            m_JobAdded.wait(lock);
+            continue;
+        }
+
+        ++pJob->m_Users;
+        lock.unlock();
+
+        const std::size_t allocationCount = Debug::AllocationCounter::GetThread();
+
+        Execute(*pJob);
+
+        const std::size_t allocations = Debug::AllocationCounter::GetThread() - allocationCount;
+
+        lock.lock();
+
+        pJob->m_Allocations += allocations;
+
+        // release the job, notify its owner if it is waiting for the last workers
+        if (!--pJob->m_Users)
+            m_JobReleased.notify_all();
+    }
+}
+//---------------------------------------------------------------------------
+void ThreadPool::Execute(IJob& job)
+{
+    // claim the items one by one, until all of them are claimed
+    for (std::size_t index = job.m_Next.fetch_add(1); index < job.m_Count; index = job.m_Next.fetch_add(1))
+        job.m_Task(job.m_pContext, index);
+}
+//---------------------------------------------------------------------------
@@ -0,0 +1,150 @@
+/****************************************************************************
+ * ==> ThreadPool ----------------------------------------------------------*
+ ****************************************************************************
+ * Description: Worker thread pool                                          *
+ * Developer:   Jean-Milost Reymond                                         *
+ ****************************************************************************
+ * MIT License                                                              *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files (the            *
+ * "Software"), to deal in the Software without restriction, including      *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sub-license, and/or sell copies of the Software, and to      *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+#pragma once
+
+// std
+#include <cstddef>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace Threading
+{
+    /**
+    * Worker thread pool, runs the items of a job concurrently on all the cores
+    *@author Jean-Milost Reymond
+    */
+    class ThreadPool
+    {
+        public:
+            /**
+            * Job item callback
+            *@param pContext - job context
+            *@param index - item index to process
+            */
+            typedef void (*ITask)(void* pContext, std::size_t index);
+
+            /**
+            * Constructor
+            *@param threadCount - thread count, including the calling one. If 0, all the cores are used
+            */
+            ThreadPool(std::size_t threadCount = 0);
+
+            virtual ~ThreadPool();
+
+            /**
+            * Runs a job and waits until all its items were processed
+            *@param count - item count
+            *@param task - callback to call for each item
+            *@param pContext - context to pass to the callback
+            *@note The calling thread also processes items. Several threads may run jobs simultaneously,
+            *      the items are processed in no particular order. The heap allocations made by the workers
+            *      are counted as made by the calling thread
+            */
+            void Run(std::size_t count, ITask task, void* pContext);
+
+            /**
+            * Runs a job and waits until all its items were processed
+            *@param count - item count
+            *@param func - function to call for each item, with the item index as parameter
+            */
+            template <class T>
+            inline void Run(std::size_t count, const T& func);
+
+            /**
+            * Gets the thread count, including the calling one
+            *@return the thread count
+            */
+            inline std::size_t GetThreadCount() const;
+
+        private:
+            /**
+            * Running job
+            */
+            struct IJob
+            {
+                ITask                    m_Task        = nullptr;
+                void*                    m_pContext    = nullptr;
+                std::size_t              m_Count       = 0;
+                std::atomic<std::size_t> m_Next        = { 0 };
+                std::size_t              m_Users       = 0;       // workers processing the job, guarded by the mutex
+                std::size_t              m_Allocations = 0;       // heap allocations of the workers, guarded by the mutex
+                IJob*                    m_pNext       = nullptr; // next running job
+            };
+
+            std::vector<std::thread> m_Workers;
+            std::mutex               m_Mutex;
+            std::condition_variable  m_JobAdded;
+            std::condition_variable  m_JobReleased;
+            IJob*                    m_pJobs = nullptr;
+            bool                     m_Exit  = false;
+
+            /**
+            * Worker thread main loop
+            */
+            void WorkerLoop();
+
+            /**
+            * Processes the job items until no item remains
+            *@param job - job to process
+            */
+            static void Execute(IJob& job);
+
+            /**
+            * Calls a function object on a job item
+            *@param pContext - function object
+            *@param index - item index
+            */
+            template <class T>
+            static void Invoke(void* pContext, std::size_t index);
+    };
+
+    //---------------------------------------------------------------------------
+    // ThreadPool
+    //---------------------------------------------------------------------------
+    template <class T>
+    void ThreadPool::Run(std::size_t count, const T& func)
+    {
+        Run(count, &Invoke<T>, (void*)&func);
+    }
+    //---------------------------------------------------------------------------
+    std::size_t ThreadPool::GetThreadCount() const
+    {
+        return m_Workers.size() + 1;
+    }
+    //---------------------------------------------------------------------------
+    template <class T>
+    void ThreadPool::Invoke(void* pContext, std::size_t index)
+    {
+        (*(const T*)pContext)(index);
+    }
+    //---------------------------------------------------------------------------
+}
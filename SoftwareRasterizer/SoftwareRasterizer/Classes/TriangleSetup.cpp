@@ -0,0 +1,142 @@
+/****************************************************************************
+ * ==> TriangleSetup -------------------------------------------------------*
+ ****************************************************************************
+ * Description: Triangle rasterization setup                                *
+ * Developer:   Jean-Milost Reymond                                         *
+ ****************************************************************************
+ * MIT License                                                              *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files (the            *
+ * "Software"), to deal in the Software without restriction, including      *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sub-license, and/or sell copies of the Software, and to      *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+#include "TriangleSetup.h"
+
+// std
+#include <algorithm>
+#include <cmath>
+
+using namespace Rasterizer;
+
+//---------------------------------------------------------------------------
+// TriangleSetup
+//---------------------------------------------------------------------------
+TriangleSetup::TriangleSetup()
+{}
+//---------------------------------------------------------------------------
+TriangleSetup::~TriangleSetup()
+{}
+//---------------------------------------------------------------------------
+bool TriangleSetup::Setup(const Geometry::Polygon& polygon,
+                          const Math::Vector2F*    st,
+                          std::size_t              width,
+                          std::size_t              height)
+{
+    const Math::Vector3F& v0 = polygon.m_Vertex[0];
+    const Math::Vector3F& v1 = polygon.m_Vertex[1];
+    const Math::Vector3F& v2 = polygon.m_Vertex[2];
+
+    std::int64_t x[3];
+    std::int64_t y[3];
+
+    // snap the vertices to the sub-pixel grid
+    for (std::size_t i = 0; i < 3; ++i)
+        if (!Snap(polygon.m_Vertex[i].m_X, x[i]) || !Snap(polygon.m_Vertex[i].m_Y, y[i]))
+            return false;
+
+    // calculate bounding box, in pixels
+    const std::int64_t minX = FloorPixel(std::min(x[0], std::min(x[1], x[2])));
+    const std::int64_t minY = FloorPixel(std::min(y[0], std::min(y[1], y[2])));
+    const std::int64_t maxX = FloorPixel(std::max(x[0], std::max(x[1], x[2])));
+    const std::int64_t maxY = FloorPixel(std::max(y[0], std::max(y[1], y[2])));
+
+    // cull if completely outside screen
+    if (maxX < 0 || minX >= (std::int64_t)width || maxY < 0 || minY >= (std::int64_t)height)
+        return false;
+
+    // clamp to screen bounds
+    m_MinX = (std::size_t)std::max(minX, (std::int64_t)0);
+    m_MaxX = (std::size_t)std::min(maxX, (std::int64_t)width  - 1);
+    m_MinY = (std::size_t)std::max(minY, (std::int64_t)0);
+    m_MaxY = (std::size_t)std::min(maxY, (std::int64_t)height - 1);
+
+    // whole triangle signed area, in squared sub-pixels
+    const std::int64_t area = (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+
+    // degenerated triangle, nothing to draw
+    if (!area)
+        return false;
+
+    // the edge equations are oriented to be positive inside the triangle, whatever its winding
+    const std::int64_t sign = area > 0 ? 1 : -1;
+
+    // first pixel center, on which the equations are calculated
+    const std::int64_t px = (std::int64_t)m_MinX * m_SubPixel + m_SubPixel / 2;
+    const std::int64_t py = (std::int64_t)m_MinY * m_SubPixel + m_SubPixel / 2;
+
+    const double invArea = 1.0 / (double)(area * sign);
+
+    IEquation weights[3];
+
+    // the signed area of the sub-triangle formed by a point p and an edge (a, b) is linear in p:
+    // area(p, a, b) = (a.y - b.y) * p.x + (b.x - a.x) * p.y + c. Dividing it by the whole triangle
+    // area gives the barycentric weight of the vertex facing the edge, which is thus also linear
+    const std::size_t edgeStart[3] = { 1, 2, 0 };
+    const std::size_t edgeEnd[3]   = { 2, 0, 1 };
+
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        const std::size_t a = edgeStart[i];
+        const std::size_t b = edgeEnd[i];
+
+        // one pixel step is a whole sub-pixel grid step
+        m_Edge[i].m_A = (y[a] - y[b]) * m_SubPixel * sign;
+        m_Edge[i].m_B = (x[b] - x[a]) * m_SubPixel * sign;
+        m_Edge[i].m_C = ((x[a] - px) * (y[b] - py) - (y[a] - py) * (x[b] - px)) * sign;
+
+        weights[i].m_A = (float)((double)m_Edge[i].m_A * invArea);
+        weights[i].m_B = (float)((double)m_Edge[i].m_B * invArea);
+        weights[i].m_C = (float)((double)m_Edge[i].m_C * invArea);
+
+        // top-left fill rule: a pixel exactly on an edge belongs to the triangle only if the edge is
+        // a left edge (the inside is on its right) or a top edge (horizontal, the inside is below it).
+        // Other edges exclude their pixels by biasing the equation, as the values are integers
+        if (!(m_Edge[i].m_A > 0 || (!m_Edge[i].m_A && m_Edge[i].m_B > 0)))
+            --m_Edge[i].m_C;
+
+        SetupQuad(m_Edge[i]);
+    }
+
+    // the depth varies monotonically between the vertices, so its range is the vertex depth range
+    m_MinZ = std::min(v0.m_Z, std::min(v1.m_Z, v2.m_Z));
+    m_MaxZ = std::max(v0.m_Z, std::max(v1.m_Z, v2.m_Z));
+
+    // invert original depth values for perspective-correct interpolation
+    const float invZ0 = 1.0f / v0.m_Z;
+    const float invZ1 = 1.0f / v1.m_Z;
+    const float invZ2 = 1.0f / v2.m_Z;
+
+    // calculate the 1/z and perspective-correct texture coordinates gradients
+    SetupInterpolant(weights, invZ0,             invZ1,             invZ2,             m_InvZ);
+    SetupInterpolant(weights, st[0].m_X * invZ0, st[1].m_X * invZ1, st[2].m_X * invZ2, m_S);
+    SetupInterpolant(weights, st[0].m_Y * invZ0, st[1].m_Y * invZ1, st[2].m_Y * invZ2, m_T);
+
+    return true;
+}
+//---------------------------------------------------------------------------
@@ -0,0 +1,275 @@
+/****************************************************************************
+ * ==> TriangleSetup -------------------------------------------------------*
+ ****************************************************************************
+ * Description: Triangle rasterization setup                                *
+ * Developer:   Jean-Milost Reymond                                         *
+ ****************************************************************************
+ * MIT License                                                              *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files (the            *
+ * "Software"), to deal in the Software without restriction, including      *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sub-license, and/or sell copies of the Software, and to      *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+#pragma once
+
+// std
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+
+// classes
+#include "Vector2.h"
+#include "Polygon.h"
+
+namespace Rasterizer
+{
+    /**
+    * Triangle rasterization setup, calculates the edge equations and the interpolant gradients
+    * once per triangle, allowing to walk the pixels by incremental additions only
+    *@note The vertices are snapped to a fixed point sub-pixel grid, and the edge equations are
+    *      integers following the top-left fill rule, so a pixel shared by adjacent triangles is
+    *      drawn exactly once, and the coverage is the same everywhere on the screen
+    *@author Jean-Milost Reymond
+    */
+    class TriangleSetup
+    {
+        public:
+            static const int          m_SubPixelBits = 8;                   // sub-pixel precision, in bits
+            static const std::int64_t m_SubPixel     = 1 << m_SubPixelBits; // sub-pixel grid steps per pixel
+
+            /**
+            * Edge equation in the screen space, value = a * (x - minX) + b * (y - minY) + c, in squared
+            * sub-pixel units. A pixel is inside the edge if its value is positive or zero
+            */
+            struct IEdge
+            {
+                std::int64_t m_A       = 0;     // value increment for each pixel on the x axis
+                std::int64_t m_B       = 0;     // value increment for each pixel on the y axis
+                std::int64_t m_C       = 0;     // value on the first bounding box pixel center, biased by the fill rule
+                std::int64_t m_Quad[4] = { 0 }; // value increments from a 2x2 pixel quad top left pixel to each of its pixels
+            };
+
+            /**
+            * Linear equation in the screen space, value = a * (x - minX) + b * (y - minY) + c
+            */
+            struct IEquation
+            {
+                float m_A       = 0.0f;     // value increment for each pixel on the x axis
+                float m_B       = 0.0f;     // value increment for each pixel on the y axis
+                float m_C       = 0.0f;     // value on the first bounding box pixel center
+                float m_Quad[4] = { 0.0f }; // value increments from a 2x2 pixel quad top left pixel to each of its pixels
+            };
+
+            /**
+            * Equation values on a pixel
+            */
+            struct IValues
+            {
+                std::int64_t m_Edge[3] = { 0 };
+                float        m_InvZ    =   0.0f;
+                float        m_S       =   0.0f;
+                float        m_T       =   0.0f;
+
+                /**
+                * Adds increments to the values
+                *@param step - increments to add
+                */
+                inline void Add(const IValues& step)
+                {
+                    m_Edge[0] += step.m_Edge[0];
+                    m_Edge[1] += step.m_Edge[1];
+                    m_Edge[2] += step.m_Edge[2];
+                    m_InvZ    += step.m_InvZ;
+                    m_S       += step.m_S;
+                    m_T       += step.m_T;
+                }
+            };
+
+            IEdge       m_Edge[3]; // edge equations, the first one is facing the first vertex, and so on
+            IEquation   m_InvZ;    // 1 / z
+            IEquation   m_S;       // s / z
+            IEquation   m_T;       // t / z
+            std::size_t m_MinX = 0;
+            std::size_t m_MinY = 0;
+            std::size_t m_MaxX = 0;
+            std::size_t m_MaxY = 0;
+            float       m_MinZ = 0.0f; // nearest vertex depth
+            float       m_MaxZ = 0.0f; // farthest vertex depth
+
+            TriangleSetup();
+            virtual ~TriangleSetup();
+
+            /**
+            * Setups the triangle for rasterization
+            *@param polygon - polygon in screen coordinates, z containing the depth
+            *@param st - polygon texture coordinates (array of 3 items)
+            *@param width - screen width
+            *@param height - screen height
+            *@return true if the triangle should be rasterized, false if degenerated, outside the screen, or
+            *        with a vertex outside the guard band (see m_GuardBand)
+            */
+            bool Setup(const Geometry::Polygon& polygon,
+                       const Math::Vector2F*    st,
+                       std::size_t              width,
+                       std::size_t              height);
+
+            /**
+            * Calculates the equation values on a pixel
+            *@param x - pixel x coordinate
+            *@param y - pixel y coordinate
+            *@param[out] values - equation values
+            *@note The pixel may be outside the bounding box
+            */
+            inline void GetValues(std::size_t x, std::size_t y, IValues& values) const;
+
+            /**
+            * Gets the equation increments between two pixels on the x axis
+            *@param distance - distance in pixels
+            *@param[out] values - equation increments
+            */
+            inline void GetStepX(std::size_t distance, IValues& values) const;
+
+            /**
+            * Gets the equation increments between two pixels on the y axis
+            *@param distance - distance in pixels
+            *@param[out] values - equation increments
+            */
+            inline void GetStepY(std::size_t distance, IValues& values) const;
+
+        private:
+            static const std::int64_t m_GuardBand = 1 << 21; // max vertex distance from the origin, in pixels, keeping the equations in 64 bit
+
+            /**
+            * Snaps a coordinate to the sub-pixel grid
+            *@param value - coordinate to snap, in pixels
+            *@param[out] snapped - snapped coordinate, in sub-pixels
+            *@return true on success, false if the coordinate is outside the guard band
+            */
+            static inline bool Snap(float value, std::int64_t& snapped);
+
+            /**
+            * Gets the pixel containing a sub-pixel coordinate
+            *@param value - coordinate, in sub-pixels
+            *@return pixel coordinate
+            */
+            static inline std::int64_t FloorPixel(std::int64_t value);
+
+            /**
+            * Calculates an interpolant gradient from the per-vertex values
+            *@param pWeights - barycentric weight equations (array of 3 items)
+            *@param v0 - value on the first vertex
+            *@param v1 - value on the second vertex
+            *@param v2 - value on the third vertex
+            *@param[out] equation - interpolant equation
+            */
+            static inline void SetupInterpolant(const IEquation* pWeights,
+                                                float            v0,
+                                                float            v1,
+                                                float            v2,
+                                                IEquation&       equation);
+
+            /**
+            * Calculates the 2x2 pixel quad increments of an equation
+            *@param[in, out] equation - equation
+            */
+            template <class T>
+            static inline void SetupQuad(T& equation);
+    };
+
+    //---------------------------------------------------------------------------
+    // TriangleSetup
+    //---------------------------------------------------------------------------
+    inline void TriangleSetup::GetValues(std::size_t x, std::size_t y, IValues& values) const
+    {
+        // offset of the pixel from the bounding box first pixel
+        const float        offsetX = (float)x - (float)m_MinX;
+        const float        offsetY = (float)y - (float)m_MinY;
+        const std::int64_t edgeX   = (std::int64_t)x - (std::int64_t)m_MinX;
+        const std::int64_t edgeY   = (std::int64_t)y - (std::int64_t)m_MinY;
+
+        values.m_Edge[0] = m_Edge[0].m_C + m_Edge[0].m_A * edgeX   + m_Edge[0].m_B * edgeY;
+        values.m_Edge[1] = m_Edge[1].m_C + m_Edge[1].m_A * edgeX   + m_Edge[1].m_B * edgeY;
+        values.m_Edge[2] = m_Edge[2].m_C + m_Edge[2].m_A * edgeX   + m_Edge[2].m_B * edgeY;
+        values.m_InvZ    = m_InvZ.m_C    + m_InvZ.m_A    * offsetX + m_InvZ.m_B    * offsetY;
+        values.m_S       = m_S.m_C       + m_S.m_A       * offsetX + m_S.m_B       * offsetY;
+        values.m_T       = m_T.m_C       + m_T.m_A       * offsetX + m_T.m_B       * offsetY;
+    }
+    //---------------------------------------------------------------------------
+    inline void TriangleSetup::GetStepX(std::size_t distance, IValues& values) const
+    {
+        values.m_Edge[0] = m_Edge[0].m_A * (std::int64_t)distance;
+        values.m_Edge[1] = m_Edge[1].m_A * (std::int64_t)distance;
+        values.m_Edge[2] = m_Edge[2].m_A * (std::int64_t)distance;
+        values.m_InvZ    = m_InvZ.m_A    * (float)distance;
+        values.m_S       = m_S.m_A       * (float)distance;
+        values.m_T       = m_T.m_A       * (float)distance;
+    }
+    //---------------------------------------------------------------------------
+    inline void TriangleSetup::GetStepY(std::size_t distance, IValues& values) const
+    {
+        values.m_Edge[0] = m_Edge[0].m_B * (std::int64_t)distance;
+        values.m_Edge[1] = m_Edge[1].m_B * (std::int64_t)distance;
+        values.m_Edge[2] = m_Edge[2].m_B * (std::int64_t)distance;
+        values.m_InvZ    = m_InvZ.m_B    * (float)distance;
+        values.m_S       = m_S.m_B       * (float)distance;
+        values.m_T       = m_T.m_B       * (float)distance;
+    }
+    //---------------------------------------------------------------------------
+    inline bool TriangleSetup::Snap(float value, std::int64_t& snapped)
+    {
+        // also rejects NaN
+        if (!(std::fabs(value) < (float)m_GuardBand))
+            return false;
+
+        // round to the nearest sub-pixel
+        snapped = (std::int64_t)std::floor((double)value * (double)m_SubPixel + 0.5);
+        return true;
+    }
+    //---------------------------------------------------------------------------
+    inline std::int64_t TriangleSetup::FloorPixel(std::int64_t value)
+    {
+        // the division truncates toward zero, the negative values should be rounded down
+        return value >= 0 ? value / m_SubPixel : -((-value + m_SubPixel - 1) / m_SubPixel);
+    }
+    //---------------------------------------------------------------------------
+    inline void TriangleSetup::SetupInterpolant(const IEquation* pWeights,
+                                                float            v0,
+                                                float            v1,
+                                                float            v2,
+                                                IEquation&       equation)
+    {
+        // the barycentric weights sum the per-vertex values, so are their gradients
+        equation.m_A = v0 * pWeights[0].m_A + v1 * pWeights[1].m_A + v2 * pWeights[2].m_A;
+        equation.m_B = v0 * pWeights[0].m_B + v1 * pWeights[1].m_B + v2 * pWeights[2].m_B;
+        equation.m_C = v0 * pWeights[0].m_C + v1 * pWeights[1].m_C + v2 * pWeights[2].m_C;
+
+        SetupQuad(equation);
+    }
+    //---------------------------------------------------------------------------
+    template <class T>
+    inline void TriangleSetup::SetupQuad(T& equation)
+    {
+        // quad pixels are ordered as top left, top right, bottom left and bottom right
+        equation.m_Quad[0] = 0;
+        equation.m_Quad[1] = equation.m_A;
+        equation.m_Quad[2] = equation.m_B;
+        equation.m_Quad[3] = equation.m_A + equation.m_B;
+    }
+    //---------------------------------------------------------------------------
+}
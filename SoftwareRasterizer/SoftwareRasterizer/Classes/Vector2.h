@@ -30,6 +30,7 @@
 
 // std
 #include <algorithm>
+#include <type_traits>
 
 namespace Math
 {
@@ -57,131 +58,136 @@ namespace Math
             * Copy constructor
             *@param other - other vector to copy from
             */
-            inline Vector2(const Vector2& other);
-
-            virtual ~Vector2();
+            Vector2(const Vector2& other) = default;
 
             /**
             * Copy operator
             *@param other - other vector to copy from
             *@return this vector
             */
-            virtual inline Vector2<T>& operator = (const Vector2<T>& other);
+            Vector2& operator = (const Vector2& other) = default;
 
             /**
             * Addition operator
             *@param value - value to add
             *@return resulting vector
             */
-            virtual inline Vector2<T> operator + (const Vector2<T>& value) const;
-            virtual inline Vector2<T> operator + (const T& value) const;
+            inline Vector2<T> operator + (const Vector2<T>& value) const;
+            inline Vector2<T> operator + (const T& value) const;
 
             /**
             * Subtraction operator
             *@param value - value to subtract
             *@return resulting vector
             */
-            virtual inline Vector2<T> operator - (const Vector2<T>& value) const;
-            virtual inline Vector2<T> operator - (const T& value) const;
+            inline Vector2<T> operator - (const Vector2<T>& value) const;
+            inline Vector2<T> operator - (const T& value) const;
 
             /**
             * Negation operator
             *@return inverted vector
             */
-            virtual inline Vector2<T> operator - () const;
+            inline Vector2<T> operator - () const;
 
             /**
             * Multiplication operator
             *@param value - value to multiply
             *@return resulting vector
             */
-            virtual inline Vector2<T> operator * (const Vector2<T>& value) const;
-            virtual inline Vector2<T> operator * (const T& value) const;
+            inline Vector2<T> operator * (const Vector2<T>& value) const;
+            inline Vector2<T> operator * (const T& value) const;
 
             /**
             * Division operator
             *@param value - value to divide
             *@return resulting vector
             */
-            virtual inline Vector2<T> operator / (const Vector2<T>& value) const;
-            virtual inline Vector2<T> operator / (const T& value) const;
+            inline Vector2<T> operator / (const Vector2<T>& value) const;
+            inline Vector2<T> operator / (const T& value) const;
 
             /**
             * Addition and assignation operator
             *@param value - value to add
             *@return resulting vector
             */
-            virtual inline const Vector2<T>& operator += (const Vector2<T>& value);
-            virtual inline const Vector2<T>& operator += (const T& value);
+            inline const Vector2<T>& operator += (const Vector2<T>& value);
+            inline const Vector2<T>& operator += (const T& value);
 
             /**
             * Subtraction and assignation operator
             *@param value - value to subtract
             *@return resulting vector
             */
-            virtual inline const Vector2<T>& operator -= (const Vector2<T>& value);
-            virtual inline const Vector2<T>& operator -= (const T& value);
+            inline const Vector2<T>& operator -= (const Vector2<T>& value);
+            inline const Vector2<T>& operator -= (const T& value);
 
             /**
             * Multiplication and assignation operator
             *@param value - value to multiply
             *@return resulting vector
             */
-            virtual inline const Vector2<T>& operator *= (const Vector2<T>& value);
-            virtual inline const Vector2<T>& operator *= (const T& value);
+            inline const Vector2<T>& operator *= (const Vector2<T>& value);
+            inline const Vector2<T>& operator *= (const T& value);
 
             /**
             * Division and assignation operator
             *@param value - value to divide
             *@return resulting vector
             */
-            virtual inline const Vector2<T>& operator /= (const Vector2<T>& value);
-            virtual inline const Vector2<T>& operator /= (const T& value);
+            inline const Vector2<T>& operator /= (const Vector2<T>& value);
+            inline const Vector2<T>& operator /= (const T& value);
 
             /**
             * Equality operator
             *@param value - value to compare
             *@return true if values are identical, otherwise false
             */
-            virtual inline bool operator == (const Vector2<T>& value) const;
+            inline bool operator == (const Vector2<T>& value) const;
 
             /**
             * Not equality operator
             *@param value - value to compare
             *@return true if values are not identical, otherwise false
             */
-            virtual inline bool operator != (const Vector2<T>& value) const;
+            inline bool operator != (const Vector2<T>& value) const;
 
             /**
             * Calculates the vector length
             *@return vector length
             */
-            virtual inline T Length() const;
+            inline T Length() const;
 
             /**
             * Normalizes the vector
             *@return normalized vector
             */
-            virtual inline Vector2<T> Normalize() const;
+            inline Vector2<T> Normalize() const;
 
             /**
             * Calculates cross product between 2 vectors
             *@param vector - other vector to cross with
             *@return the resulting vector
             */
-            virtual inline Vector2 Cross(const Vector2& vector) const;
+            inline Vector2 Cross(const Vector2& vector) const;
 
             /**
             * Calculates dot product between 2 vectors
             *@param vector - other vector to dot with
             *@return resulting angle
             */
-            virtual inline T Dot(const Vector2& vector) const;
+            inline T Dot(const Vector2& vector) const;
     };
 
     typedef Vector2<float>  Vector2F;
     typedef Vector2<double> Vector2D;
 
+    static_assert(sizeof(Vector2F) == 2 * sizeof(float),  "Vector2F should only contain its values");
+    static_assert(sizeof(Vector2D) == 2 * sizeof(double), "Vector2D should only contain its values");
+    static_assert(std::is_trivially_copyable<Vector2F>::value && std::is_standard_layout<Vector2F>::value,
+                  "Vector2F should be trivially copyable and have a standard layout");
+    static_assert(std::is_trivially_copyable<Vector2D>::value && std::is_standard_layout<Vector2D>::value,
+                  "Vector2D should be trivially copyable and have a standard layout");
+
     //---------------------------------------------------------------------------
     // Vector2
     //---------------------------------------------------------------------------
@@ -197,25 +203,6 @@ namespace Math
         m_Y(y)
     {}
     //---------------------------------------------------------------------------
-    template <class T>
-    Vector2<T>::Vector2(const Vector2& other) :
-        m_X(other.m_X),
-        m_Y(other.m_Y)
-    {}
-    //---------------------------------------------------------------------------
-    template <class T>
-    Vector2<T>::~Vector2()
-    {}
-    //---------------------------------------------------------------------------
-    template<class T>
-    Vector2<T>& Vector2<T>::operator = (const Vector2& other)
-    {
-        m_X = other.m_X;
-        m_Y = other.m_Y;
-
-        return *this;
-    }
-    //---------------------------------------------------------------------------
     template<class T>
     Vector2<T> Vector2<T>::operator + (const Vector2& value) const
     {
@@ -30,6 +30,7 @@
 
 // std
 #include <algorithm>
+#include <type_traits>
 
 namespace Math
 {
@@ -59,131 +60,137 @@ namespace Math
             * Copy constructor
             *@param other - other vector to copy from
             */
-            inline Vector3(const Vector3& other);
-
-            virtual ~Vector3();
+            Vector3(const Vector3& other) = default;
 
             /**
             * Copy operator
             *@param other - other vector to copy from
             *@return this vector
             */
-            virtual inline Vector3& operator = (const Vector3& other);
+            Vector3& operator = (const Vector3& other) = default;
 
             /**
             * Addition operator
             *@param value - value to add
             *@return resulting vector
             */
-            virtual inline Vector3 operator + (const Vector3& value) const;
-            virtual inline Vector3 operator + (const T& value) const;
+            inline Vector3 operator + (const Vector3& value) const;
+            inline Vector3 operator + (const T& value) const;
 
             /**
             * Subtraction operator
             *@param value - value to subtract
             *@return resulting vector
             */
-            virtual inline Vector3 operator - (const Vector3& value) const;
-            virtual inline Vector3 operator - (const T& value) const;
+            inline Vector3 operator - (const Vector3& value) const;
+            inline Vector3 operator - (const T& value) const;
 
             /**
             * Negation operator
             *@return inverted vector
             */
-            virtual inline Vector3 operator - () const;
+            inline Vector3 operator - () const;
 
             /**
             * Multiplication operator
             *@param value - value to multiply
             *@return resulting vector
             */
-            virtual inline Vector3 operator * (const Vector3& value) const;
-            virtual inline Vector3 operator * (const T& value) const;
+            inline Vector3 operator * (const Vector3& value) const;
+            inline Vector3 operator * (const T& value) const;
 
             /**
             * Division operator
             *@param value - value to divide
             *@return resulting vector
             */
-            virtual inline Vector3 operator / (const Vector3& value) const;
-            virtual inline Vector3 operator / (const T& value) const;
+            inline Vector3 operator / (const Vector3& value) const;
+            inline Vector3 operator / (const T& value) const;
 
             /**
             * Addition and assignation operator
             *@param value - value to add
             *@return resulting vector
             */
-            virtual inline const Vector3& operator += (const Vector3& value);
-            virtual inline const Vector3& operator += (const T& value);
+            inline const Vector3& operator += (const Vector3& value);
+            inline const Vector3& operator += (const T& value);
 
             /**
             * Subtraction and assignation operator
             *@param value - value to subtract
             *@return resulting vector
             */
-            virtual inline const Vector3& operator -= (const Vector3& value);
-            virtual inline const Vector3& operator -= (const T& value);
+            inline const Vector3& operator -= (const Vector3& value);
+            inline const Vector3& operator -= (const T& value);
 
             /**
             * Multiplication and assignation operator
             *@param value - value to multiply
             *@return resulting vector
             */
-            virtual inline const Vector3& operator *= (const Vector3& value);
-            virtual inline const Vector3& operator *= (const T& value);
+            inline const Vector3& operator *= (const Vector3& value);
+            inline const Vector3& operator *= (const T& value);
 
             /**
             * Division and assignation operator
             *@param value - value to divide
             *@return resulting vector
             */
-            virtual inline const Vector3& operator /= (const Vector3& value);
-            virtual inline const Vector3& operator /= (const T& value);
+            inline const Vector3& operator /= (const Vector3& value);
+            inline const Vector3& operator /= (const T& value);
 
             /**
             * Equality operator
             *@param value - value to compare
             *@return true if values are identical, otherwise false
             */
-            virtual inline bool operator == (const Vector3& value) const;
+            inline bool operator == (const Vector3& value) const;
 
             /**
             * Not equality operator
             *@param value - value to compare
             *@return true if values are not identical, otherwise false
             */
-            virtual inline bool operator != (const Vector3& value) const;
+            inline bool operator != (const Vector3& value) const;
 
             /**
             * Calculates the vector length
             *@return vector length
             */
-            virtual inline T Length() const;
+            inline T Length() const;
 
             /**
             * Normalizes the vector
             *@return normalized vector
             */
-            virtual inline Vector3 Normalize() const;
+            inline Vector3 Normalize() const;
 
             /**
             * Calculates cross product between 2 vectors
             *@param vector - other vector to cross with
             *@return the resulting vector
             */
-            virtual inline Vector3 Cross(const Vector3& vector) const;
+            inline Vector3 Cross(const Vector3& vector) const;
 
             /**
             * Calculates dot product between 2 vectors
             *@param vector - other vector to dot with
             *@return resulting angle
             */
-            virtual inline T Dot(const Vector3& vector) const;
+            inline T Dot(const Vector3& vector) const;
     };
 
     typedef Vector3<float>  Vector3F;
     typedef Vector3<double> Vector3D;
 
+    // the types may be copied with memcpy, loaded with SIMD instructions or written as is in binary files
+    static_assert(sizeof(Vector3F) == 3 * sizeof(float),  "Vector3F should only contain its values");
+    static_assert(sizeof(Vector3D) == 3 * sizeof(double), "Vector3D should only contain its values");
+    static_assert(std::is_trivially_copyable<Vector3F>::value && std::is_standard_layout<Vector3F>::value,
+                  "Vector3F should be trivially copyable and have a standard layout");
+    static_assert(std::is_trivially_copyable<Vector3D>::value && std::is_standard_layout<Vector3D>::value,
+                  "Vector3D should be trivially copyable and have a standard layout");
+
     //---------------------------------------------------------------------------
     // Vector3
     //---------------------------------------------------------------------------
@@ -201,27 +208,6 @@ namespace Math
         m_Z(z)
     {}
     //---------------------------------------------------------------------------
-    template <class T>
-    Vector3<T>::Vector3(const Vector3& other) :
-        m_X(other.m_X),
-        m_Y(other.m_Y),
-        m_Z(other.m_Z)
-    {}
-    //---------------------------------------------------------------------------
-    template <class T>
-    Vector3<T>::~Vector3()
-    {}
-    //---------------------------------------------------------------------------
-    template<class T>
-    Vector3<T>& Vector3<T>::operator = (const Vector3& other)
-    {
-        m_X = other.m_X;
-        m_Y = other.m_Y;
-        m_Z = other.m_Z;
-
-        return *this;
-    }
-    //---------------------------------------------------------------------------
     template<class T>
     Vector3<T> Vector3<T>::operator + (const Vector3& value) const
     {
@@ -29,87 +29,372 @@
 #include "WaveFront.h"
 
 // std
-#include <iostream>
-#include <fstream>
-#include <sstream>
+#include <cstring>
+#include <charconv>
+#include <algorithm>
+
+// classes
+#include "MappedFile.h"
 
 using namespace Model;
 
+//------------------------------------------------------------------------------
+// Global functions
+//------------------------------------------------------------------------------
+/**
+* Checks if a character is a blank one
+*@param c - character to check
+*@return true if the character is blank, otherwise false
+*/
+static inline bool IsBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+//------------------------------------------------------------------------------
+/**
+* Skips the blank characters
+*@param p - current position
+*@param pEnd - line end
+*@return the first non blank position
+*/
+static inline const char* SkipBlanks(const char* p, const char* pEnd)
+{
+    while (p < pEnd && IsBlank(*p))
+        ++p;
+
+    return p;
+}
+//------------------------------------------------------------------------------
+/**
+* Finds the next line
+*@param p - current position
+*@param pEnd - content end
+*@return the next line start, after the line feed character, or the content end
+*/
+static inline const char* FindNextLine(const char* p, const char* pEnd)
+{
+    const char* pLineFeed = (const char*)std::memchr(p, '\n', (std::size_t)(pEnd - p));
+    return pLineFeed ? pLineFeed + 1 : pEnd;
+}
+//------------------------------------------------------------------------------
+/**
+* WaveFront line type
+*/
+enum class IELineType
+{
+    Unknown,
+    Vertex,
+    TexCoord,
+    Normal,
+    Face
+};
+//------------------------------------------------------------------------------
+/**
+* Gets a line type
+*@param p - line start, after the blank characters
+*@param pEnd - line end
+*@return the line type, unknown for the comments and the unused items
+*/
+static inline IELineType GetLineType(const char* p, const char* pEnd)
+{
+    if (pEnd - p < 2)
+        return IELineType::Unknown;
+
+    if (IsBlank(p[1]))
+        switch (p[0])
+        {
+            case 'v': return IELineType::Vertex;
+            case 'f': return IELineType::Face;
+            default:  return IELineType::Unknown;
+        }
+
+    if (p[0] != 'v' || pEnd - p < 3 || !IsBlank(p[2]))
+        return IELineType::Unknown;
+
+    switch (p[1])
+    {
+        case 't': return IELineType::TexCoord;
+        case 'n': return IELineType::Normal;
+        default:  return IELineType::Unknown;
+    }
+}
+//------------------------------------------------------------------------------
+/**
+* Parses a float
+*@param p - current position
+*@param pEnd - line end
+*@param[out] value - parsed value, unchanged on error
+*@return the position after the value
+*/
+static inline const char* ParseFloat(const char* p, const char* pEnd, float& value)
+{
+    p = SkipBlanks(p, pEnd);
+
+    // from_chars doesn't accept the plus sign
+    if (p < pEnd && *p == '+')
+        ++p;
+
+    const std::from_chars_result result = std::from_chars(p, pEnd, value);
+
+    return result.ec == std::errc() ? result.ptr : p;
+}
+//------------------------------------------------------------------------------
+/**
+* Parses a face index, and converts it to a zero based one
+*@param p - current position
+*@param pEnd - line end
+*@param count - item count parsed so far, to resolve the negative indices
+*@param[out] index - parsed index, -1 if invalid
+*@return the position after the index
+*/
+static inline const char* ParseIndex(const char* p, const char* pEnd, std::size_t count, int& index)
+{
+    int value = 0;
+
+    if (p < pEnd && *p == '+')
+        ++p;
+
+    const std::from_chars_result result = std::from_chars(p, pEnd, value);
+
+    if (result.ec != std::errc())
+    {
+        index = -1;
+        return p;
+    }
+
+    // OBJ indices start at 1, the negative ones are relative to the last parsed item
+    if (value > 0)
+        index = value - 1;
+    else
+    if (value < 0)
+        index = (int)count + value;
+    else
+        index = -1;
+
+    return result.ptr;
+}
 //------------------------------------------------------------------------------
 // WaveFront
 //------------------------------------------------------------------------------
-WaveFront::IMesh WaveFront::Load(const std::string& fileName)
+WaveFront::IMesh WaveFront::Load(const std::string& fileName, Threading::ThreadPool* pThreadPool)
+{
+    IO::MappedFile file;
+
+    if (!file.Open(fileName))
+        return IMesh();
+
+    return Parse(file.GetData(), file.GetData() + file.GetSize(), pThreadPool);
+}
+//------------------------------------------------------------------------------
+WaveFront::IMesh WaveFront::Parse(const char* pBegin, const char* pEnd, Threading::ThreadPool* pThreadPool)
 {
-    IMesh         mesh;
-    std::ifstream file(fileName);
+    IMesh mesh;
 
-    if (!file.is_open())
+    if (!pBegin || pBegin >= pEnd)
         return mesh;
 
-    std::string line;
+    const std::size_t size       = (std::size_t)(pEnd - pBegin);
+    const std::size_t maxChunks  = pThreadPool ? pThreadPool->GetThreadCount() * 4 : 1;
+    const std::size_t chunkCount = std::max<std::size_t>(std::min(maxChunks, size / m_MinChunkSize), 1);
+
+    // split the content in chunks, each ending after a line feed, so no line is shared between 2 chunks
+    std::vector<const char*> chunks(chunkCount + 1);
+    chunks[0] = pBegin;
+
+    for (std::size_t i = 1; i < chunkCount; ++i)
+        chunks[i] = std::max(chunks[i - 1], FindNextLine(pBegin + (size * i) / chunkCount, pEnd));
+
+    chunks[chunkCount] = pEnd;
 
-    while (std::getline(file, line))
+    std::vector<ICounts> offsets(chunkCount + 1);
+
+    // count the items of each chunk first, to allocate the mesh arrays only once
+    auto countChunk = [&chunks, &offsets](std::size_t chunk)
+                      {
+                          offsets[chunk + 1] = CountItems(chunks[chunk], chunks[chunk + 1]);
+                      };
+
+    if (pThreadPool && chunkCount > 1)
+        pThreadPool->Run(chunkCount, countChunk);
+    else
+        countChunk(0);
+
+    // accumulate the counts, so each chunk knows where its items start in the mesh. This also resolves
+    // the negative indices referring to the items of the previous chunks
+    for (std::size_t i = 1; i <= chunkCount; ++i)
+    {
+        offsets[i].m_Vertices  += offsets[i - 1].m_Vertices;
+        offsets[i].m_TexCoords += offsets[i - 1].m_TexCoords;
+        offsets[i].m_Normals   += offsets[i - 1].m_Normals;
+        offsets[i].m_Faces     += offsets[i - 1].m_Faces;
+    }
+
+    mesh.m_Vertices.resize(offsets[chunkCount].m_Vertices);
+    mesh.m_TexCoords.resize(offsets[chunkCount].m_TexCoords);
+    mesh.m_Normals.resize(offsets[chunkCount].m_Normals);
+    mesh.m_Faces.resize(offsets[chunkCount].m_Faces);
+
+    // each chunk writes its own items, so they may be parsed concurrently
+    auto parseChunk = [&chunks, &offsets, &mesh](std::size_t chunk)
+                      {
+                          ParseItems(chunks[chunk], chunks[chunk + 1], offsets[chunk], mesh);
+                      };
+
+    if (pThreadPool && chunkCount > 1)
+        pThreadPool->Run(chunkCount, parseChunk);
+    else
+        parseChunk(0);
+
+    return mesh;
+}
+//------------------------------------------------------------------------------
+void WaveFront::Append(const char* pBegin, const char* pEnd, IMesh& mesh)
+{
+    if (!pBegin || pBegin >= pEnd)
+        return;
+
+    const ICounts counts = CountItems(pBegin, pEnd);
+
+    // the new items are written after the existing ones
+    ICounts offsets;
+    offsets.m_Vertices  = mesh.m_Vertices.size();
+    offsets.m_TexCoords = mesh.m_TexCoords.size();
+    offsets.m_Normals   = mesh.m_Normals.size();
+    offsets.m_Faces     = mesh.m_Faces.size();
+
+    mesh.m_Vertices.resize(offsets.m_Vertices   + counts.m_Vertices);
+    mesh.m_TexCoords.resize(offsets.m_TexCoords + counts.m_TexCoords);
+    mesh.m_Normals.resize(offsets.m_Normals     + counts.m_Normals);
+    mesh.m_Faces.resize(offsets.m_Faces         + counts.m_Faces);
+
+    ParseItems(pBegin, pEnd, offsets, mesh);
+}
+//------------------------------------------------------------------------------
+WaveFront::ICounts WaveFront::CountItems(const char* pBegin, const char* pEnd)
+{
+    ICounts     counts;
+    const char* pLineEnd;
+
+    for (const char* p = pBegin; p < pEnd; p = pLineEnd)
+    {
+        pLineEnd = FindNextLine(p, pEnd);
+
+        switch (GetLineType(SkipBlanks(p, pLineEnd), pLineEnd))
+        {
+            case IELineType::Vertex:   ++counts.m_Vertices;  break;
+            case IELineType::TexCoord: ++counts.m_TexCoords; break;
+            case IELineType::Normal:   ++counts.m_Normals;   break;
+            case IELineType::Face:     ++counts.m_Faces;     break;
+            default:                                         break;
+        }
+    }
+
+    return counts;
+}
+//------------------------------------------------------------------------------
+void WaveFront::ParseItems(const char* pBegin, const char* pEnd, const ICounts& offsets, IMesh& mesh)
+{
+    // current item positions in the mesh, which are also the item counts parsed so far
+    std::size_t vertexIndex   = offsets.m_Vertices;
+    std::size_t texCoordIndex = offsets.m_TexCoords;
+    std::size_t normalIndex   = offsets.m_Normals;
+    std::size_t faceIndex     = offsets.m_Faces;
+    const char* pLineEnd;
+
+    for (const char* p = pBegin; p < pEnd; p = pLineEnd)
     {
-        std::istringstream iss(line);
-        std::string        prefix;
-        iss >> prefix;
+        pLineEnd = FindNextLine(p, pEnd);
+        p        = SkipBlanks(p, pLineEnd);
+
+        // only the "v", "vt", "vn" and "f" lines are used, the comments and other items are skipped
+        const IELineType type = GetLineType(p, pLineEnd);
 
-        if (prefix == "v")
+        if (type == IELineType::Vertex)
         {
             // vertex position
             Math::Vector3F v;
-            iss >> v.m_X >> v.m_Y >> v.m_Z;
-            mesh.m_Vertices.push_back(v);
+            p = ParseFloat(p + 2, pLineEnd, v.m_X);
+            p = ParseFloat(p,     pLineEnd, v.m_Y);
+                ParseFloat(p,     pLineEnd, v.m_Z);
+            mesh.m_Vertices[vertexIndex++] = v;
         }
         else
-        if (prefix == "vt")
+        if (type == IELineType::TexCoord)
         {
             // texture coordinate
             Math::Vector2F vt;
-            iss >> vt.m_X >> vt.m_Y;
-            mesh.m_TexCoords.push_back(vt);
+            p = ParseFloat(p + 3, pLineEnd, vt.m_X);
+                ParseFloat(p,     pLineEnd, vt.m_Y);
+            mesh.m_TexCoords[texCoordIndex++] = vt;
         }
         else
-        if (prefix == "vn")
+        if (type == IELineType::Normal)
         {
             // vertex normal
             Math::Vector3F vn;
-            iss >> vn.m_X >> vn.m_Y >> vn.m_Z;
-            mesh.m_Normals.push_back(vn);
+            p = ParseFloat(p + 3, pLineEnd, vn.m_X);
+            p = ParseFloat(p,     pLineEnd, vn.m_Y);
+                ParseFloat(p,     pLineEnd, vn.m_Z);
+            mesh.m_Normals[normalIndex++] = vn;
         }
         else
-        if (prefix == "f")
+        if (type == IELineType::Face)
         {
-            // face
-            IFace       face;
-            std::string vertex;
+            // count the face vertices, to allocate the face arrays only once
+            std::size_t cornerCount = 0;
 
-            while (iss >> vertex)
+            for (const char* pToken = SkipBlanks(p + 2, pLineEnd); pToken < pLineEnd; pToken = SkipBlanks(pToken, pLineEnd))
             {
-                std::replace(vertex.begin(), vertex.end(), '/', ' ');
-                std::istringstream viss(vertex);
+                ++cornerCount;
+
+                while (pToken < pLineEnd && !IsBlank(*pToken))
+                    ++pToken;
+            }
+
+            // face
+            IFace& face = mesh.m_Faces[faceIndex++];
+
+            face.m_VertexIndices.reserve(cornerCount);
 
-                int vIdx, vtIdx, vnIdx;
-                viss >> vIdx;
+            p = SkipBlanks(p + 2, pLineEnd);
 
-                // OBJ indices start at 1
-                face.m_VertexIndices.push_back(vIdx - 1);
+            // each face vertex is written as v, v/vt, v//vn or v/vt/vn
+            while (p < pLineEnd)
+            {
+                int index;
+                p = ParseIndex(p, pLineEnd, vertexIndex, index);
+                face.m_VertexIndices.push_back(index);
 
-                if (viss >> vtIdx)
+                if (p < pLineEnd && *p == '/')
                 {
-                    face.m_TexCoordIndices.push_back(vtIdx - 1);
+                    ++p;
+
+                    if (p < pLineEnd && *p != '/')
+                    {
+                        if (face.m_TexCoordIndices.empty())
+                            face.m_TexCoordIndices.reserve(cornerCount);
+
+                        p = ParseIndex(p, pLineEnd, texCoordIndex, index);
+                        face.m_TexCoordIndices.push_back(index);
+                    }
+
+                    if (p < pLineEnd && *p == '/')
+                    {
+                        if (face.m_NormalIndices.empty())
+                            face.m_NormalIndices.reserve(cornerCount);
 
-                    if (viss >> vnIdx)
-                        face.m_NormalIndices.push_back(vnIdx - 1);
+                        p = ParseIndex(p + 1, pLineEnd, normalIndex, index);
+                        face.m_NormalIndices.push_back(index);
+                    }
                 }
-            }
 
-            mesh.m_Faces.push_back(face);
+                // skip any unexpected character up to the next face vertex
+                while (p < pLineEnd && !IsBlank(*p))
+                    ++p;
+
+                p = SkipBlanks(p, pLineEnd);
+            }
         }
     }
-
-    file.close();
-
-    return mesh;
 }
 //------------------------------------------------------------------------------
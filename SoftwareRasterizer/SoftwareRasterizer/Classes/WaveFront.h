@@ -35,6 +35,7 @@
 // classes
 #include "Vector2.h"
 #include "Vector3.h"
+#include "ThreadPool.h"
 
 namespace Model
 {
@@ -69,8 +70,62 @@ namespace Model
             /**
             * Loads a WaveFront file
             *@param fileName - WaveFront file name to open
+            *@param pThreadPool - if not null, the file is split in chunks parsed concurrently by this pool
             *@returns opened mesh, empty mesh on error
+            *@note The file is memory mapped and parsed in place
             */
-            static IMesh Load(const std::string& fileName);
+            static IMesh Load(const std::string& fileName, Threading::ThreadPool* pThreadPool = nullptr);
+
+            /**
+            * Parses a WaveFront content
+            *@param pBegin - content start
+            *@param pEnd - content end, excluded
+            *@param pThreadPool - if not null, the content is split in chunks parsed concurrently by this pool
+            *@returns parsed mesh
+            *@note The negative face indices are resolved relatively to the data parsed before them. The result
+            *      is the same whether the content is parsed concurrently or not
+            */
+            static IMesh Parse(const char* pBegin, const char* pEnd, Threading::ThreadPool* pThreadPool = nullptr);
+
+            /**
+            * Parses a WaveFront content part, and appends its items to a mesh
+            *@param pBegin - part start, on a line start
+            *@param pEnd - part end, excluded, after a line feed or on the content end
+            *@param[in, out] mesh - mesh to append the items to
+            *@note The negative face indices are resolved relatively to all the mesh items, so a content may
+            *      be parsed part by part while it arrives
+            */
+            static void Append(const char* pBegin, const char* pEnd, IMesh& mesh);
+
+        private:
+            static const std::size_t m_MinChunkSize = 256 * 1024; // smallest content chunk parsed by a worker
+
+            /**
+            * Item counts of a content chunk, or item offsets of a chunk in the mesh
+            */
+            struct ICounts
+            {
+                std::size_t m_Vertices  = 0;
+                std::size_t m_TexCoords = 0;
+                std::size_t m_Normals   = 0;
+                std::size_t m_Faces     = 0;
+            };
+
+            /**
+            * Counts the items of a content chunk
+            *@param pBegin - chunk start, on a line start
+            *@param pEnd - chunk end, excluded, after a line feed or on the content end
+            *@return the chunk item counts
+            */
+            static ICounts CountItems(const char* pBegin, const char* pEnd);
+
+            /**
+            * Parses the items of a content chunk
+            *@param pBegin - chunk start, on a line start
+            *@param pEnd - chunk end, excluded, after a line feed or on the content end
+            *@param offsets - offsets of the chunk first items in the mesh
+            *@param[in, out] mesh - mesh to fill, should be already large enough to contain all the items
+            */
+            static void ParseItems(const char* pBegin, const char* pEnd, const ICounts& offsets, IMesh& mesh);
     };
 }
@@ -36,6 +36,9 @@
 #include "Matrix4x4.h"
 #include "Texture.h"
 #include "WaveFront.h"
+#include "MeshCache.h"
+#include "MeshStreamer.h"
+#include "MeshletBuilder.h"
 #include "OpenGL.h"
 #include "SoftwareRenderer.h"
 
@@ -268,8 +271,19 @@ int APIENTRY wWinMain(_In_     HINSTANCE hInstance,
     // set up viewport and projection
     OpenGL::SetupViewport(hWnd);
 
-    // load the WaveFront model
-    Model::WaveFront::IMesh mesh = Model::WaveFront::Load("..\\..\\Assets\\Models\\Cat\\model.obj");
+    const std::string                modelName = "..\\..\\Assets\\Models\\Cat\\model.obj";
+    Model::MeshCache                 meshCache;
+    Model::MeshStreamer              meshStreamer;
+    Model::MeshletBuilder::IMeshlets meshlets;
+
+    // open the compiled model from its cache if up to date, otherwise stream it while rendering
+    bool streaming = !meshCache.Open(modelName, nullptr, false);
+
+    if (streaming && !meshStreamer.Open(modelName))
+    {
+        ::MessageBox(hWnd, L"Failed to load the model", L"Error", MB_OK);
+        return 1;
+    }
 
     OpenGL::Renderer     openGLRenderer;
     Rasterizer::Renderer softwareRenderer;
@@ -277,6 +291,7 @@ int APIENTRY wWinMain(_In_     HINSTANCE hInstance,
     // initialize the software renderer
     softwareRenderer.Initialize(hWnd, hDC);
     softwareRenderer.SetProjection();
+    softwareRenderer.SetRenderMode(Rasterizer::Renderer::IERenderMode::Binned);
 
     Texture::Loader loader;
     int             width, height;
@@ -316,6 +331,32 @@ int APIENTRY wWinMain(_In_     HINSTANCE hInstance,
             double elapsedTime = (double)::GetTickCount64() - lastTime;
                    lastTime    = (double)::GetTickCount64();
 
+            if (streaming)
+            {
+                // load the next model part, and cache the model once complete
+                meshStreamer.Read();
+
+                if (meshStreamer.IsComplete())
+                {
+                    if (meshCache.Build(modelName, meshStreamer.GetMesh()))
+                        meshStreamer.Close();
+
+                    streaming = false;
+                }
+            }
+
+            // the streamed mesh is drawn while it's loading, or if it couldn't be cached
+            const Model::MeshCompiler::IMeshView mesh = meshStreamer.GetMesh().m_Indices.empty() ?
+                    meshCache.GetMesh() : Model::MeshCompiler::IMeshView(meshStreamer.GetMesh());
+
+            // split the complete mesh in meshlets, so its parts facing away or outside the view are skipped early.
+            // The rendered content no longer changes after, so the frames should no longer allocate
+            if (!streaming && meshlets.m_Meshlets.empty())
+            {
+                meshlets = Model::MeshletBuilder::Build(mesh);
+                softwareRenderer.SetSteadyState(!meshlets.m_Meshlets.empty());
+            }
+
             // calculate model position and rotation
             Math::Matrix4x4F model =  Math::Matrix4x4F::Identity();
             model.m_Table[3][2]    = -250.0f;
@@ -354,8 +395,11 @@ int APIENTRY wWinMain(_In_     HINSTANCE hInstance,
                 // set model matrix
                 softwareRenderer.SetModel(model);
 
-                // render the mesh
-                softwareRenderer.Render(mesh);
+                // render the mesh, by meshlets once complete
+                if (meshlets.m_Meshlets.empty())
+                    softwareRenderer.Render(mesh);
+                else
+                    softwareRenderer.Render(mesh, meshlets);
 
                 // swap buffers to display
                 softwareRenderer.SwapBuffers();